@@ -0,0 +1,185 @@
+// File: bench/main.cpp
+// 命令和条件的微基准测试：不初始化终端，结果以JSON输出到标准输出
+//
+// 用法：GameEngineBench [--iterations N] [--filter 子串]
+//   --iterations 每个用例的执行次数（默认1000000）
+//   --filter     只运行名称包含该子串的用例
+#include "GameEngine.h"
+#include "CommandParser.h"
+#include "ConditionEvaluator.h"
+#include "LoadProfiler.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+// ================= 用例 =================
+
+namespace {
+constexpr std::size_t WARMUP_ITERATIONS = 1000; ///< 计时前的预热次数
+
+/**
+ * @brief 一个基准用例
+ */
+struct BenchCase {
+    std::string group;              ///< 分组：command、condition、expression
+    std::string name;               ///< 用例名称（命令或条件原文，混合用例为mix）
+    std::function<int()> operation; ///< 执行一次操作，返回值防止被优化掉
+};
+
+/**
+ * @brief 一个用例的测量结果
+ */
+struct BenchResult {
+    const BenchCase* bench;
+    std::size_t iterations;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+volatile int sink = 0; ///< 吸收操作结果
+
+BenchResult run(const BenchCase& bench, std::size_t iterations) {
+    int acc = 0;
+    for (std::size_t i = 0; i < WARMUP_ITERATIONS; ++i) acc += bench.operation();
+
+    // 基准测试链接了AllocationCounter.cpp，替换全局operator new按线程计数（见LoadProfiler）
+    const std::uint64_t allocsBefore = LoadProfiler::counters().allocations;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) acc += bench.operation();
+    const auto end = std::chrono::steady_clock::now();
+    const std::uint64_t allocs = LoadProfiler::counters().allocations - allocsBefore;
+
+    sink = sink + acc;
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return {&bench, iterations, ns / iterations, static_cast<double>(allocs) / iterations};
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+// 按顺序轮流执行一组操作，衡量混合负载（不同入口的缓存互相干扰）
+std::function<int()> makeMix(std::vector<std::function<int()>> operations) {
+    return [operations = std::move(operations), next = std::size_t(0)]() mutable {
+        const int result = operations[next]();
+        if (++next == operations.size()) next = 0;
+        return result;
+    };
+}
+
+// 基准场景：一张带NPC的地图、计分项、变量、背包物品和地点标记
+void setupWorld(GameEngine& engine) {
+    const char* setup[] = {
+        "/map create main width=40 height=40",
+        "/map setblock main 3 3 npc name=guard",
+        "/map setblock main 6 6 npc name=merchant",
+        "/scoreboard objectives add kills",
+        "/scoreboard set @e[type=npc,map=main] kills 7",
+        "/scoreboard set gold 10",
+        "/scoreboard set level 3",
+        "/item define key display=k",
+        "/item give key",
+    };
+    for (const char* line : setup) CommandParser::parseAndExecute(line, engine);
+    engine.getVisitedMarkers().insert("village");
+    CommandParser::flushDiagnostics();
+}
+
+std::vector<BenchCase> makeCases(GameEngine& engine) {
+    std::vector<BenchCase> cases;
+    auto addGroup = [&](const std::string& group, const std::vector<std::string>& inputs,
+                        const std::function<std::function<int()>(const std::string&)>& bind) {
+        std::vector<std::function<int()>> mix;
+        for (const auto& input : inputs) {
+            cases.push_back({group, input, bind(input)});
+            mix.push_back(bind(input));
+        }
+        cases.push_back({group, "mix", makeMix(std::move(mix))});
+    };
+
+    addGroup("command", {
+        "/scoreboard set gold 10",
+        "/scoreboard operation level += 1",
+        "/entity set guard hp 5",
+        "/map setblock main 5 5 wall",
+        "/scoreboard set @e[type=npc,map=main] kills 7",
+    }, [&engine](const std::string& line) {
+        return std::function<int()>([&engine, line]() {
+            CommandParser::parseAndExecute(line, engine);
+            return 0;
+        });
+    });
+
+    addGroup("condition", {
+        "have key",
+        "去过 village",
+        "gold is 10",
+        "gold >= 10",
+        "level<5",
+        "guard.kills == 7",
+        "merchant.kills != {gold}",
+    }, [&engine](const std::string& condition) {
+        return std::function<int()>([&engine, condition]() {
+            return ConditionEvaluator::evaluate(engine, condition) ? 1 : 0;
+        });
+    });
+
+    addGroup("expression", {
+        "42",
+        "{gold}+3",
+        "{guard.kills} * 2",
+    }, [&engine](const std::string& expr) {
+        return std::function<int()>([&engine, expr]() {
+            return ConditionEvaluator::evaluateExpression(engine, expr);
+        });
+    });
+    return cases;
+}
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t iterations = 1000000;
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) iterations = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else {
+            std::fprintf(stderr, "用法: %s [--iterations N] [--filter 子串]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (iterations == 0) iterations = 1;
+
+    GameEngine engine;
+    setupWorld(engine);
+    const std::vector<BenchCase> cases = makeCases(engine);
+
+    std::vector<BenchResult> results;
+    for (const auto& bench : cases) {
+        const std::string fullName = bench.group + "/" + bench.name;
+        if (!filter.empty() && fullName.find(filter) == std::string::npos) continue;
+        results.push_back(run(bench, iterations));
+    }
+    CommandParser::flushDiagnostics();
+
+    std::printf("{\n  \"benchmarks\": [\n");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        std::printf("    {\"group\": \"%s\", \"name\": \"%s\", \"iterations\": %zu, "
+                    "\"ns_per_op\": %.2f, \"allocs_per_op\": %.2f}%s\n",
+                    r.bench->group.c_str(), jsonEscape(r.bench->name).c_str(), r.iterations,
+                    r.nsPerOp, r.allocsPerOp, i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+    return EXIT_SUCCESS;
+}
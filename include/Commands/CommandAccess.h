@@ -0,0 +1,52 @@
+// include/Commands/CommandAccess.h
+#pragma once
+#include "CompiledCommand.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct CommandAccess
+ * @brief 一条命令读写的引擎状态（加载时静态分析得出）
+ *
+ * 状态划分：
+ * - 单张地图：/map create|setblock|fill 只写参数中的地图
+ * - 注册表：物品定义、NPC模板、全局变量、计分项、物品栏、对话框
+ * - 无法确定范围的命令（选择器、/entity、/teleport、引用{实体名.计分项}的/scoreboard、未知命令）视为屏障，
+ *   与前后所有命令串行
+ *
+ * 两条命令互不冲突（没有一方写入另一方读写的状态）时可以并发执行，
+ * 结果与顺序执行相同。
+ */
+struct CommandAccess {
+    /// 注册表类状态（按位组合）
+    enum Resource : std::uint32_t {
+        ITEMS      = 1 << 0, ///< 物品定义
+        NPCS       = 1 << 1, ///< NPC模板
+        VARIABLES  = 1 << 2, ///< 全局变量
+        SCOREBOARD = 1 << 3, ///< 实体计分项
+        INVENTORY  = 1 << 4, ///< 物品栏
+        DIALOG     = 1 << 5  ///< 对话框
+    };
+
+    std::uint32_t reads = 0;  ///< 读取的注册表
+    std::uint32_t writes = 0; ///< 写入的注册表
+    std::string map;          ///< 写入的地图（空表示不访问地图）
+    bool barrier = false;     ///< 访问范围未知，必须串行
+
+    /**
+     * @brief 分析一条命令的读写集合
+     * @param command 编译后的命令
+     */
+    static CommandAccess analyze(const CompiledCommand& command);
+
+    /**
+     * @brief 将命令序列划分为可并发执行的批次
+     * @param accesses 各命令的读写集合（按源顺序）
+     * @return 批次列表，每批为命令下标（批内按源顺序，批内命令互不冲突）
+     *
+     * 每条命令的批次号 = 与它冲突的前序命令的最大批次号 + 1，
+     * 按资源记录最近一次读/写所在批次，分析为线性时间。
+     */
+    static std::vector<std::vector<std::size_t>> planWaves(const std::vector<CommandAccess>& accesses);
+};
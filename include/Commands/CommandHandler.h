@@ -2,12 +2,43 @@
 
 #pragma once
 #include "GameEngine.h"
+#include "CommandSchema.h"
 #include "Log.h"
 #include <vector>
 #include <string>
 
 class CommandHandler {
 public:
+    /**
+     * @param command 命令名（如 /map）
+     * @param hasSubcommands 是否有子命令
+     *
+     * 子类在构造函数中向subcommands注册各子命令的参数模式和处理函数
+     */
+    explicit CommandHandler(std::string command, bool hasSubcommands = true)
+        : subcommands(std::move(command), hasSubcommands) {}
     virtual ~CommandHandler() = default;
-    virtual void handle(const std::vector<std::string>& args, GameEngine& engine) = 0;
-};
\ No newline at end of file
+
+    /**
+     * @brief 执行命令：查找子命令，按参数模式解析后调用处理函数
+     * @return 未知子命令、参数错误或执行失败时失败
+     */
+    virtual CommandStatus handle(const std::vector<std::string>& args, GameEngine& engine) {
+        return subcommands.dispatch(args, engine);
+    }
+
+    /**
+     * @brief 是否自行处理实体选择器参数（如 @e[type=npc]）
+     *
+     * 返回false时，CommandParser会将选择器展开为各实体名称并逐个执行命令
+     */
+    virtual bool acceptsSelectors() const { return false; }
+
+    /**
+     * @brief 子命令分派表（编译命令时预先查找子命令）
+     */
+    const CommandSchema::CommandTable& getSubcommands() const { return subcommands; }
+
+protected:
+    CommandSchema::CommandTable subcommands;
+};
@@ -2,9 +2,12 @@
 
 #pragma once
 #include "CommandHandler.h"
+#include "CompiledCommand.h"
 #include "Log.h"
 #include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 class CommandParser {
     Log log;
@@ -14,15 +17,128 @@ public:
         return instance;
     }
     
+    /**
+     * @brief 解析并执行一行命令
+     * @param commandLine 命令文本
+     * @param engine 游戏引擎引用
+     *
+     * 编译结果按文本缓存，重复执行同一行（如对话选项）时不再分词
+     */
     static void parseAndExecute(const std::string& commandLine, GameEngine& engine);
+    
+    /**
+     * @brief 将一行命令编译为预解析形式
+     * @param commandLine 命令文本
+     * @param line 源文件行号
+     * @return 编译结果（空行返回args为空的命令）
+     */
+    static CompiledCommand compile(const std::string& commandLine, int line = 0);
+    
+    /**
+     * @brief 将已分词的命令编译为预解析形式
+     * @param tokens 命令参数（tokens[0]为命令名）
+     * @param line 源文件行号
+     * @return 编译结果
+     */
+    static CompiledCommand compile(std::vector<std::string> tokens, int line = 0);
+    
+    /**
+     * @brief 执行预解析的命令
+     * @param command 编译结果
+     * @param engine 游戏引擎引用
+     *
+     * 错误处理与parseAndExecute一致：记录错误后继续
+     */
+    static void execute(const CompiledCommand& command, GameEngine& engine);
+
+    /**
+     * @brief 注册外部命令（如插件命令）
+     * @param cmd 命令名（如 /fish）
+     * @param handler 命令处理器
+     * @return 是否注册成功（已有同名命令时不覆盖，返回false）
+     *
+     * 应在编译脚本之前调用；已缓存的编译结果会被清除
+     */
+    static bool addCommand(const std::string& cmd, std::unique_ptr<CommandHandler> handler);
+
+    /**
+     * @brief 检查命令是否已注册
+     * @param cmd 命令名
+     */
+    static bool hasCommand(const std::string& cmd) { return getInstance().commands.count(cmd) > 0; }
+
+    /**
+     * @brief 按前缀列出命令名（控制台补全）
+     * @param prefix 命令名前缀（如 /ma）
+     * @return 按字典序排列的命令名
+     */
+    static std::vector<std::string> completeCommand(std::string_view prefix) {
+        return getInstance().commandNames.complete(prefix);
+    }
+
+    /**
+     * @brief 查找命令处理器
+     * @param cmd 命令名
+     * @return 处理器，未注册时为nullptr
+     */
+    static const CommandHandler* findCommand(const std::string& cmd);
+
+    /**
+     * @brief 记录一条命令错误
+     * @param message 错误信息
+     *
+     * 错误先缓存在内存中，由flushDiagnostics批量写入error.log；可在工作线程中调用
+     */
+    static void report(std::string message);
+
+    /**
+     * @brief 将缓存的错误一次写入error.log
+     *
+     * 引擎在每批命令结束时调用；缓存达到上限或程序退出时也会写入
+     */
+    static void flushDiagnostics() { getInstance().flushBuffered(); }
+
+    /**
+     * @class DiagnosticsCapture
+     * @brief 在作用域内额外收集命令错误（如控制台显示命令结果）
+     *
+     * 错误默认仍照常写入error.log；divert为true时只收集不记录（由调用者稍后按需report）。
+     * 嵌套时内层生效，结束后恢复外层
+     */
+    class DiagnosticsCapture {
+    public:
+        explicit DiagnosticsCapture(std::vector<std::string>& messages, bool divert = false);
+        ~DiagnosticsCapture();
+
+        DiagnosticsCapture(const DiagnosticsCapture&) = delete;
+        DiagnosticsCapture& operator=(const DiagnosticsCapture&) = delete;
+
+    private:
+        std::vector<std::string>* previous;
+        bool previousDivert;
+    };
+
+    ~CommandParser() { flushBuffered(); }
 
 private:
     CommandParser();
     std::unordered_map<std::string, std::unique_ptr<CommandHandler>> commands;
+    PrefixTrie commandNames;                                         ///< 已注册的命令名（补全用）
+    std::unordered_map<std::string, CompiledCommand> compiledCache; ///< 命令文本 -> 编译结果
+    static constexpr size_t MAX_CACHED_COMMANDS = 4096;             ///< 缓存上限（超出后不再缓存新命令）
+    std::mutex diagnosticsMutex;
+    std::vector<std::string> diagnostics;                            ///< 尚未写入error.log的错误
+    std::vector<std::string>* capture = nullptr;                     ///< 额外收集错误的位置（见DiagnosticsCapture）
+    bool divertCapture = false;                                      ///< 收集的错误不再写入error.log
+    static constexpr size_t MAX_BUFFERED_DIAGNOSTICS = 256;          ///< 缓存上限（达到后立即写入）
     
     void registerCommand(const std::string& cmd, std::unique_ptr<CommandHandler> handler) {
+        if (!commands.count(cmd)) commandNames.insert(cmd);
         commands[cmd] = std::move(handler);
     }
 
+    void flushBuffered();
     void executeCommandImpl(const std::string& commandLine, GameEngine& engine);
+    void executeCompiled(const CompiledCommand& command, GameEngine& engine);
+    void expandSelector(const CompiledCommand& command, size_t index, GameEngine& engine);
 };
\ No newline at end of file
@@ -0,0 +1,352 @@
+// include/Commands/CommandSchema.h
+#pragma once
+#include "CommandStatus.h"
+#include "CommandUtils.h"
+#include "PrefixTrie.h"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class GameEngine;
+
+/**
+ * @namespace CommandSchema
+ * @brief 声明式的命令参数模式
+ *
+ * 每个子命令用参数类型列表声明其参数，例如：
+ *
+ *     const Parser<Word, Coord, Word, Options> SETBLOCK{"/map", "setblock", {"map", "x y", "type", "options..."}};
+ *
+ * 由类型列表生成：
+ * - 解析：按顺序从参数中取值，得到强类型的元组，直接作为处理函数的参数
+ * - 校验：参数不足时返回带用法的错误，坐标等格式错误时返回对应错误（不抛出异常）
+ * - 用法：/map setblock <map> <x> <y> <type> [options...]
+ *
+ * 参数名中以空格分隔的每个词单独显示为一个占位符。
+ */
+namespace CommandSchema {
+
+/**
+ * @class Cursor
+ * @brief 解析位置和错误状态
+ *
+ * 出错后其余参数不再解析，各类型返回占位值；由Parser转换为错误信息
+ */
+class Cursor {
+public:
+    Cursor(const std::vector<std::string>& args, std::size_t index) : args(args), index(index) {}
+
+    const std::vector<std::string>& args;
+    std::size_t index; ///< 下一个参数的下标
+
+    /**
+     * @brief 是否还能继续解析（之前出错或参数不足时返回false，参数不足时记为缺少参数）
+     */
+    bool need(std::size_t count = 1) {
+        if (failed()) return false;
+        if (index + count > args.size()) missing = true;
+        return !missing;
+    }
+
+    bool failed() const { return missing || !error.empty(); }
+    void fail(std::string message) { if (!failed()) error = std::move(message); }
+
+    bool missing = false; ///< 参数不足
+    std::string error;    ///< 格式错误信息
+
+    static const std::string EMPTY; ///< 出错时引用类型参数的占位值
+};
+
+/// 单个参数
+struct Word {
+    using Value = const std::string&;
+    static constexpr bool OPTIONAL = false;
+    static Value parse(Cursor& cursor, const char* name);
+};
+
+/// 坐标：x,y（一个参数）或 x y（两个参数）
+struct Coord {
+    using Value = std::pair<int, int>;
+    static constexpr bool OPTIONAL = false;
+    static Value parse(Cursor& cursor, const char* name);
+};
+
+/// 正整数（如回合数）
+struct Count {
+    using Value = int;
+    static constexpr bool OPTIONAL = false;
+    static Value parse(Cursor& cursor, const char* name);
+
+    /**
+     * @brief 将文本转换为正整数
+     * @return 正整数，不是正整数时为空
+     */
+    static std::optional<int> convert(std::string_view text);
+};
+
+/// 剩余参数原样保留（至少一个，如要延后执行的命令）
+struct Tokens {
+    using Value = std::vector<std::string>;
+    static constexpr bool OPTIONAL = false;
+    static Value parse(Cursor& cursor, const char* name);
+};
+
+/// 可省略的单个 key=value 参数（参数名形如 key=说明，只在键匹配时取用）
+struct Setting {
+    using Value = std::optional<std::string>;
+    static constexpr bool OPTIONAL = true;
+    static Value parse(Cursor& cursor, const char* name);
+};
+
+/// 剩余参数以空格连接（至少一个）
+struct Text {
+    using Value = std::string;
+    static constexpr bool OPTIONAL = false;
+    static Value parse(Cursor& cursor, const char* name);
+};
+
+/// 剩余参数以换行连接（至少一个，如多行对话）
+struct Lines {
+    using Value = std::string;
+    static constexpr bool OPTIONAL = false;
+    static Value parse(Cursor& cursor, const char* name);
+};
+
+/// 剩余参数中的 key=value（可以没有）
+struct Options {
+    using Value = CommandUtils::Params;
+    static constexpr bool OPTIONAL = true;
+    static Value parse(Cursor& cursor, const char* name);
+};
+
+/// 剩余参数中的 key=value（至少一个参数）
+struct Assignments {
+    using Value = CommandUtils::Params;
+    static constexpr bool OPTIONAL = false;
+    static Value parse(Cursor& cursor, const char* name);
+};
+
+/// 固定关键字（参数名即关键字，如 objectives add）
+struct Keyword {
+    using Value = const std::string&;
+    static constexpr bool OPTIONAL = false;
+    static constexpr bool KEYWORD = true;
+    static Value parse(Cursor& cursor, const char* name);
+};
+
+/// 可省略的参数（省略时为空）
+template<typename T>
+struct Optional {
+    using Value = std::optional<std::decay_t<typename T::Value>>;
+    static constexpr bool OPTIONAL = true;
+    static Value parse(Cursor& cursor, const char* name) {
+        if (cursor.failed() || cursor.index >= cursor.args.size()) return std::nullopt;
+        return T::parse(cursor, name);
+    }
+};
+
+/// 参数类型是否为关键字（关键字在用法中原样显示）
+template<typename T, typename = void>
+struct IsKeyword : std::false_type {};
+template<typename T>
+struct IsKeyword<T, std::void_t<decltype(T::KEYWORD)>> : std::bool_constant<T::KEYWORD> {};
+
+/**
+ * @brief 生成一个参数的用法片段
+ * @param name 参数名（以空格分隔的每个词单独显示）
+ * @param optional 是否可省略（[name]，否则为<name>）
+ * @param keyword 是否为关键字（原样显示）
+ */
+std::string formatUsage(const char* name, bool optional, bool keyword);
+
+/**
+ * @class Parser
+ * @brief 一个子命令的参数模式
+ * @tparam Args 参数类型列表（按顺序）
+ */
+template<typename... Args>
+class Parser {
+public:
+    using Values = std::tuple<typename Args::Value...>;
+    using Names = std::array<const char*, sizeof...(Args)>;
+
+    /**
+     * @param command 命令名（如 /map）
+     * @param subcommand 子命令名（没有子命令时为空字符串）
+     * @param names 各参数名
+     */
+    Parser(const char* command, const char* subcommand, Names names)
+        : subcommand(subcommand), start(*subcommand ? 2 : 1), names(names) {
+        usage = command;
+        if (*subcommand) usage += std::string(" ") + subcommand;
+        [[maybe_unused]] std::size_t i = 0;
+        ((usage += " " + formatUsage(this->names[i++], Args::OPTIONAL, IsKeyword<Args>::value)), ...);
+    }
+
+    /**
+     * @brief 解析参数
+     * @param args 命令参数（args[0]为命令名）
+     * @param status 输出：参数不足或格式错误时为失败
+     * @return 各参数的值（Word类型引用args中的字符串；失败时为占位值，不应使用）
+     */
+    Values parse(const std::vector<std::string>& args, CommandStatus& status) const {
+        Cursor cursor(args, start);
+        Values values = parse(cursor, std::index_sequence_for<Args...>{});
+        if (cursor.missing) status = CommandStatus::failure("参数不足，用法: " + usage);
+        else if (!cursor.error.empty()) status = CommandStatus::failure(std::move(cursor.error));
+        return values;
+    }
+
+    const std::string& getSubcommand() const { return subcommand; }
+    const std::string& getUsage() const { return usage; }
+
+private:
+    std::string subcommand;
+    std::size_t start; ///< 第一个参数的下标
+    Names names;
+    std::string usage;
+
+    template<std::size_t... Is>
+    Values parse([[maybe_unused]] Cursor& cursor, std::index_sequence<Is...>) const {
+        // 花括号初始化保证按参数顺序求值
+        return Values{Args::parse(cursor, names[Is])...};
+    }
+};
+
+/**
+ * @class Subcommand
+ * @brief 已绑定处理函数的子命令（类型擦除）
+ */
+class Subcommand {
+public:
+    virtual ~Subcommand() = default;
+
+    /**
+     * @brief 解析参数并调用处理函数
+     * @return 参数错误时为解析错误，否则为处理函数的结果
+     */
+    virtual CommandStatus invoke(const std::vector<std::string>& args, GameEngine& engine) const = 0;
+
+    /**
+     * @brief 只解析参数、不执行（校验模式）
+     * @return 参数不足或格式错误时失败
+     */
+    virtual CommandStatus check(const std::vector<std::string>& args) const = 0;
+
+    virtual const std::string& getName() const = 0;
+    virtual const std::string& getUsage() const = 0;
+};
+
+/// 子命令的具体实现：处理函数签名为 CommandStatus (GameEngine&, 原始参数, 各参数值...)
+template<typename Handler, typename Method, typename... Args>
+class BoundSubcommand final : public Subcommand {
+public:
+    BoundSubcommand(const Parser<Args...>& parser, Handler* handler, Method method)
+        : parser(parser), handler(handler), method(method) {}
+
+    CommandStatus invoke(const std::vector<std::string>& args, GameEngine& engine) const override {
+        CommandStatus status;
+        auto values = parser.parse(args, status);
+        if (!status) return status;
+        return std::apply([&](auto&&... values) {
+            return (handler->*method)(engine, args, std::forward<decltype(values)>(values)...);
+        }, std::move(values));
+    }
+
+    CommandStatus check(const std::vector<std::string>& args) const override {
+        CommandStatus status;
+        (void)parser.parse(args, status);
+        return status;
+    }
+
+    const std::string& getName() const override { return parser.getSubcommand(); }
+    const std::string& getUsage() const override { return parser.getUsage(); }
+
+private:
+    Parser<Args...> parser;
+    Handler* handler;
+    Method method;
+};
+
+/**
+ * @class CommandTable
+ * @brief 一个命令的子命令分派表
+ *
+ * 子命令名经哈希表常数时间查找；同名子命令可额外注册选择器形式
+ * （第一个参数为实体选择器时使用，如 /scoreboard set @e[...] <objective> <value>）。
+ * 脚本编译时即查好子命令并保存在CompiledCommand中，执行时不再查找。
+ */
+class CommandTable {
+public:
+    /**
+     * @param command 命令名
+     * @param hasSubcommands 是否有子命令（如/teleport没有，注册时子命令名为空字符串）
+     */
+    explicit CommandTable(std::string command, bool hasSubcommands = true)
+        : command(std::move(command)), hasSubcommands(hasSubcommands) {}
+
+    /**
+     * @brief 注册子命令
+     * @param parser 参数模式
+     * @param handler 处理对象
+     * @param method 处理函数
+     * @param selectorForm 是否为选择器形式
+     */
+    template<typename Handler, typename Method, typename... Args>
+    void add(const Parser<Args...>& parser, Handler* handler, Method method, bool selectorForm = false) {
+        entries.push_back(std::make_unique<BoundSubcommand<Handler, Method, Args...>>(parser, handler, method));
+        auto [it, added] = index.try_emplace(parser.getSubcommand());
+        if (added && !it->first.empty()) names.insert(it->first);
+        (selectorForm ? it->second.selector : it->second.plain) = entries.back().get();
+    }
+
+    /**
+     * @brief 按参数查找子命令
+     * @return 子命令（未知子命令或缺少子命令时为nullptr）
+     */
+    const Subcommand* find(const std::vector<std::string>& args) const;
+
+    /**
+     * @brief 查找并执行子命令
+     * @return 未知子命令、参数错误或执行失败时失败
+     */
+    CommandStatus dispatch(const std::vector<std::string>& args, GameEngine& engine) const;
+
+    /**
+     * @brief 按前缀列出子命令名（控制台补全）
+     * @param prefix 子命令名前缀
+     * @return 按字典序排列的子命令名
+     */
+    std::vector<std::string> complete(std::string_view prefix) const { return names.complete(prefix); }
+
+    /**
+     * @brief 是否没有注册任何子命令（自行解析参数的命令，如插件命令）
+     */
+    bool empty() const { return entries.empty(); }
+
+    /**
+     * @brief 命令总体用法，如 /map <create|setblock|fill>
+     */
+    std::string usage() const;
+
+private:
+    struct Overloads {
+        const Subcommand* plain = nullptr;
+        const Subcommand* selector = nullptr;
+    };
+
+    std::string command;
+    bool hasSubcommands;
+    std::vector<std::unique_ptr<Subcommand>> entries; ///< 按注册顺序
+    std::unordered_map<std::string, Overloads> index; ///< 子命令名 -> 实现
+    PrefixTrie names;                                 ///< 子命令名（补全用）
+};
+
+} // namespace CommandSchema
@@ -0,0 +1,21 @@
+// include/Commands/CommandStatus.h
+#pragma once
+#include <string>
+#include <utility>
+
+/**
+ * @struct CommandStatus
+ * @brief 命令执行结果
+ *
+ * 参数错误、对象不存在等可预期的失败以返回值报告，不抛出异常；成功时不分配内存。
+ * 异常只用于意外情况，由CommandParser兜底记录。
+ */
+struct [[nodiscard]] CommandStatus {
+    bool ok = true;
+    std::string message; ///< 失败原因
+
+    static CommandStatus success() { return {}; }
+    static CommandStatus failure(std::string message) { return {false, std::move(message)}; }
+
+    explicit operator bool() const { return ok; }
+};
@@ -1,12 +1,80 @@
 // include/Commands/CommandUtils.h
 
 #pragma once
+#include "CommandStatus.h"
+#include <optional>
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
 class CommandUtils {
 public:
-    static std::unordered_map<std::string, std::string> parseNamedParams(const std::vector<std::string>& args, size_t start = 0);
-    static std::pair<int, int> parseCoordinates(const std::vector<std::string>& args, size_t index);
-};
\ No newline at end of file
+    /**
+     * @class ParamView
+     * @brief 命令参数中 key=value 的只读视图（不复制、不分配内存）
+     *
+     * 直接引用分词后的参数，查找时在参数中线性扫描（命令的命名参数通常只有几个）。
+     * 同一个键出现多次时以最后一个为准。视图的生命周期不能超过其引用的参数。
+     */
+    class ParamView {
+    public:
+        ParamView() = default;
+        ParamView(const std::vector<std::string>& args, size_t start) : args(&args), start(start) {}
+
+        /**
+         * @brief 查找参数值
+         * @return 参数值（引用原参数），不存在时为空
+         */
+        std::optional<std::string_view> find(std::string_view key) const;
+
+        bool has(std::string_view key) const { return find(key).has_value(); }
+
+        /**
+         * @brief 获取参数值，不存在时返回默认值
+         */
+        std::string_view get(std::string_view key, std::string_view fallback = {}) const {
+            return find(key).value_or(fallback);
+        }
+
+        /**
+         * @brief 读取整数参数
+         * @param value 输出值（参数不存在时保持不变）
+         * @return 参数存在但不是整数时失败
+         */
+        CommandStatus getInt(std::string_view key, int& value) const;
+
+        /**
+         * @brief 按出现顺序遍历所有 key=value
+         * @param visit 回调，参数为 (key, value)
+         */
+        template<typename Visit>
+        void forEach(Visit&& visit) const {
+            if (!args) return;
+            for (size_t i = start; i < args->size(); ++i) {
+                std::string_view arg = (*args)[i];
+                size_t eqPos = arg.find('=');
+                if (eqPos != std::string_view::npos) visit(arg.substr(0, eqPos), arg.substr(eqPos + 1));
+            }
+        }
+
+    private:
+        const std::vector<std::string>* args = nullptr;
+        size_t start = 0;
+    };
+
+    using Params = ParamView; ///< 命名参数 key -> value
+
+    static Params parseNamedParams(const std::vector<std::string>& args, size_t start = 0) { return {args, start}; }
+
+    /**
+     * @brief 解析坐标：x,y（一个参数）或 x y（两个参数）
+     * @return 坐标，参数不足或不是整数时为空
+     */
+    static std::optional<std::pair<int, int>> parseCoordinates(const std::vector<std::string>& args, size_t index);
+
+    /**
+     * @brief 解析整数（与stoi一致：允许前导空白和正号，忽略末尾多余字符）
+     * @return 解析结果，不是整数时为空
+     */
+    static std::optional<int> toInt(std::string_view text);
+};
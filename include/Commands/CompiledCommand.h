@@ -0,0 +1,25 @@
+// include/Commands/CompiledCommand.h
+#pragma once
+#include <string>
+#include <vector>
+
+class CommandHandler;
+namespace CommandSchema { class Subcommand; }
+
+/**
+ * @struct CompiledCommand
+ * @brief 预解析的命令（脚本编译产物）
+ *
+ * 脚本加载时每行命令只分词一次，并预先查找好命令处理器和子命令，
+ * 之后的每次执行都直接调用子命令的处理函数，不再经过文本解析和字符串分派。
+ */
+struct CompiledCommand {
+    CommandHandler* handler = nullptr;  ///< 预解析的命令处理器（未知命令为nullptr）
+    const CommandSchema::Subcommand* subcommand = nullptr; ///< 预解析的子命令（未知子命令为nullptr）
+    std::vector<std::string> args;      ///< 已分词的参数（args[0]为命令名）
+    bool hasSelector = false;           ///< 参数中是否包含实体选择器
+    int line = 0;                       ///< 源文件行号（0表示非脚本来源）
+};
+
+/// 顺序执行的命令序列（如init块、物品使用效果）
+using CommandProgram = std::vector<CompiledCommand>;
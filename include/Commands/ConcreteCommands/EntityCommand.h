@@ -6,8 +6,10 @@
 
 class EntityCommand : public CommandHandler {
 public:
-    void handle(const std::vector<std::string>& args, GameEngine& engine) override;
+    EntityCommand();
+    bool acceptsSelectors() const override { return true; }
 
 private:
-    void handleSet(const std::vector<std::string>& args, GameEngine& engine);
+    CommandStatus handleSet(GameEngine& engine, const std::vector<std::string>& args,
+                            const std::string& name, const std::string& property, std::string value);
 };
\ No newline at end of file
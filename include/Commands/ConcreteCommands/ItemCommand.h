@@ -6,12 +6,15 @@
 
 class ItemCommand : public CommandHandler {
 public:
-    void handle(const std::vector<std::string>& args, GameEngine& engine) override;
+    ItemCommand();
 
 private:
-    void handleDefine(const std::vector<std::string>& args, GameEngine& engine);
-    void handleSetProperty(const std::vector<std::string>& args, GameEngine& engine);
-    void handleGive(const std::vector<std::string>& args, GameEngine& engine);
+    CommandStatus handleDefine(GameEngine& engine, const std::vector<std::string>& args,
+                               const std::string& name, CommandUtils::Params params);
+    CommandStatus handleSetProperty(GameEngine& engine, const std::vector<std::string>& args,
+                                    const std::string& name, CommandUtils::Params params);
+    CommandStatus handleGive(GameEngine& engine, const std::vector<std::string>& args,
+                             const std::string& itemName, CommandUtils::Params params);
     
     // 属性类型转换器
     template<typename T>
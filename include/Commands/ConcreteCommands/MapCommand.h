@@ -3,20 +3,67 @@
 #include "CommandHandler.h"
 #include "GameMap.h"
 #include "GameObject.h"
+#include <map>
+#include <optional>
+#include <unordered_map>
 
 class MapCommand : public CommandHandler {
 public:
-    void handle(const std::vector<std::string>& args, GameEngine& engine) override;
+    MapCommand();
     virtual ~MapCommand() = default;
 
+    /// setblock/fill命令的解析结果（setblock的两角相同；引用原命令参数，不能超过其生命周期）
+    struct Placement {
+        const std::string& map;
+        int x1, y1, x2, y2;
+        const std::string& type;
+        CommandUtils::Params params;
+    };
+
+    /**
+     * @brief 在独立的地图对象上执行一条/map命令（不访问游戏引擎）
+     * @param map 目标地图（create会整体替换）
+     * @param args 命令参数
+     * @param items 物品定义库（放置item类型时使用）
+     * @return 参数错误或物品未定义时失败
+     *
+     * 用于后台线程预构建地图
+     */
+    static CommandStatus apply(GameMap& map, const std::vector<std::string>& args,
+                               const std::map<std::string, GameObject>& items);
+
+    /**
+     * @brief 按参数模式解析setblock/fill命令
+     * @param args 命令参数
+     * @return 目标地图、区域、类型和选项（不是setblock/fill、参数不足或坐标格式错误时为空）
+     */
+    static std::optional<Placement> parsePlacement(const std::vector<std::string>& args);
+
 private:
-    void handleCreate(const std::vector<std::string>& args, GameEngine& engine);
-    void handleSetBlock(const std::vector<std::string>& args, GameEngine& engine);
-    void handleFill(const std::vector<std::string>& args, GameEngine& engine);
+    CommandStatus handleCreate(GameEngine& engine, const std::vector<std::string>& args,
+                               const std::string& name, CommandUtils::Params params);
+    CommandStatus handleSetBlock(GameEngine& engine, const std::vector<std::string>& args, const std::string& mapName,
+                                 std::pair<int, int> pos, const std::string& type, CommandUtils::Params params);
+    CommandStatus handleFill(GameEngine& engine, const std::vector<std::string>& args, const std::string& mapName,
+                             std::pair<int, int> from, std::pair<int, int> to, const std::string& type, CommandUtils::Params params);
+    
+    static CommandStatus buildMap(CommandUtils::Params params, GameMap& map);
+    static CommandStatus placeBlock(GameMap& map, std::pair<int, int> pos, const std::string& type,
+                                    CommandUtils::Params params, const std::map<std::string, GameObject>& items);
+    static CommandStatus fillArea(GameMap& map, std::pair<int, int> from, std::pair<int, int> to, const std::string& type,
+                                  CommandUtils::Params params, const std::map<std::string, GameObject>& items);
+    static CommandStatus makeObject(const std::string& type, CommandUtils::Params params,
+                                    const std::map<std::string, GameObject>& items,
+                                    const std::unordered_map<std::string, char>& displays, GameObject& obj);
     
     // 默认显示字符映射
     inline static const std::unordered_map<std::string, char> DEFAULT_DISPLAYS = {
         {"wall", '#'}, {"npc", '@'}, {"item", '$'},
         {"trap", '^'}, {"marker", '*'}
     };
-};
\ No newline at end of file
+    
+    // fill命令的默认显示字符
+    inline static const std::unordered_map<std::string, char> FILL_DISPLAYS = {
+        {"wall", '#'}, {"trap", '^'}
+    };
+};
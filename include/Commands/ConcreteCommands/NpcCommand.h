@@ -5,11 +5,13 @@
 
 class NpcCommand : public CommandHandler {
 public:
-    void handle(const std::vector<std::string>& args, GameEngine& engine) override;
+    NpcCommand();
 
 private:
-    void handleCreate(const std::vector<std::string>& args, GameEngine& engine);
-    void handleSetDialogue(const std::vector<std::string>& args, GameEngine& engine);
+    CommandStatus handleCreate(GameEngine& engine, const std::vector<std::string>& args,
+                               const std::string& name, CommandUtils::Params params);
+    CommandStatus handleSetDialogue(GameEngine& engine, const std::vector<std::string>& args,
+                                    const std::string& name, const std::string& condition, std::string dialogue);
     
     // NPC默认属性
     inline static const std::unordered_map<std::string, char> DEFAULT_DISPLAYS = {
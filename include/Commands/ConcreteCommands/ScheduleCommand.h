@@ -0,0 +1,14 @@
+// File: src/GameEngine/Commands/ConcreteCommands/ScheduleCommand.h
+#pragma once
+#include "CommandHandler.h"
+
+class ScheduleCommand : public CommandHandler {
+public:
+    ScheduleCommand();
+
+private:
+    CommandStatus handleAdd(GameEngine& engine, const std::vector<std::string>& args, const std::string& name, int delay,
+                            std::optional<std::string> every, std::vector<std::string> command);
+    CommandStatus handleCancel(GameEngine& engine, const std::vector<std::string>& args, const std::string& name);
+    CommandStatus handleList(GameEngine& engine, const std::vector<std::string>& args);
+};
@@ -5,10 +5,21 @@
 
 class ScoreboardCommand : public CommandHandler {
 public:
-    void handle(const std::vector<std::string>& args, GameEngine& engine) override;
+    ScoreboardCommand();
+    bool acceptsSelectors() const override { return true; }
 
 private:
-    void handleAdd(const std::vector<std::string>& args, GameEngine& engine);
-    void handleSet(const std::vector<std::string>& args, GameEngine& engine);
-    void handleOperation(const std::vector<std::string>& args, GameEngine& engine);
+    CommandStatus handleAdd(GameEngine& engine, const std::vector<std::string>& args, const std::string& varName);
+    CommandStatus handleSet(GameEngine& engine, const std::vector<std::string>& args,
+                            const std::string& varName, std::string expr);
+    CommandStatus handleOperation(GameEngine& engine, const std::vector<std::string>& args,
+                                  const std::string& varName, const std::string& op, std::string exprStr);
+    CommandStatus handleObjectives(GameEngine& engine, const std::vector<std::string>& args, const std::string& keyword,
+                                   const std::string& objective, CommandUtils::Params params);
+
+    // 实体计分项：set/operation 的第一个参数为选择器时使用
+    CommandStatus handleEntitySet(GameEngine& engine, const std::vector<std::string>& args, const std::string& selector,
+                                  const std::string& objective, std::string exprStr);
+    CommandStatus handleEntityOperation(GameEngine& engine, const std::vector<std::string>& args, const std::string& selector,
+                                        const std::string& objective, const std::string& op, std::string exprStr);
 };
\ No newline at end of file
@@ -5,5 +5,9 @@
 
 class TeleportCommand : public CommandHandler {
 public:
-    void handle(const std::vector<std::string>& args, GameEngine& engine) override;
+    TeleportCommand();
+
+private:
+    CommandStatus handleTeleport(GameEngine& engine, const std::vector<std::string>& args,
+                                 const std::string& mapName, std::pair<int, int> pos);
 };
\ No newline at end of file
@@ -4,8 +4,9 @@
 
 class TriggerCommand : public CommandHandler {
 public:
-    void handle(const std::vector<std::string>& args, GameEngine& engine) override;
+    TriggerCommand();
 
 private:
-    void handleNpcInteract(const std::vector<std::string>& args, GameEngine& engine);
+    CommandStatus handleNpcInteract(GameEngine& engine, const std::vector<std::string>& args,
+                                    const std::string& name, std::optional<std::string> condition);
 };
\ No newline at end of file
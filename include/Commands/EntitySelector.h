@@ -0,0 +1,141 @@
+// include/Commands/EntitySelector.h
+#pragma once
+#include "GameMap.h"
+#include "GameObject.h"
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+class GameEngine;
+
+/**
+ * @struct SelectedEntity
+ * @brief 选择器命中的地图实体
+ */
+struct SelectedEntity {
+    const std::string& mapName; ///< 所在地图名称
+    GameMap& map;               ///< 所在地图
+    GameObject& object;         ///< 实体对象（可修改属性）
+};
+
+/**
+ * @class EntitySelector
+ * @brief 实体选择器，按条件批量选取地图上的实体
+ *
+ * 语法（类似Minecraft，参数间不能有空格）：
+ * - @e                                  所有地图上的所有实体
+ * - @e[type=npc,map=main]               按类型和地图筛选
+ * - @e[name=guard]                      按名称筛选
+ * - @e[x=10,y=10,r=5]                   以(x,y)为圆心、半径5的范围（缺省为玩家位置）
+ * - @e[prop:health<50]                  按属性比较（支持 = == != < <= > >=）
+ * - @e[type=npc,limit=3]                最多选取3个
+ *
+ * 解析流程：
+ * 1. 指定name/type时通过地图的名称/类型索引取候选
+ * 2. 指定范围时只遍历坐标条带内的对象
+ * 3. 其余条件逐个过滤，结果以惰性区间返回
+ *
+ * 指定坐标或半径而未指定map时，默认在当前地图查找。
+ * 遍历期间不要增删地图对象，如需修改布局请先收集结果。
+ */
+class EntitySelector {
+public:
+    class Iterator;
+    class Range;
+
+    /**
+     * @class Iterator
+     * @brief 结果迭代器，每次前进时才查找下一个命中实体
+     */
+    class Iterator {
+    public:
+        Iterator() = default;
+        Iterator(GameEngine& engine, const EntitySelector& selector);
+        SelectedEntity operator*() const;
+        Iterator& operator++();
+        bool operator==(const Iterator& other) const { return done == other.done; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    private:
+        using MapIter = std::map<std::string, GameMap>::iterator;
+        using ObjectIter = std::map<std::pair<int, int>, GameObject>::iterator;
+
+        const EntitySelector* selector = nullptr;
+        MapIter mapIt, mapEnd;
+        const GameMap::PositionSet* bucket = nullptr; ///< 索引候选集合（无索引时为空）
+        GameMap::PositionSet::const_iterator bucketIt;
+        ObjectIter objectIt, objectEnd;
+        ObjectIter current;
+        int centerX = 0, centerY = 0;
+        std::size_t yielded = 0;
+        bool done = true;
+
+        void enterMap();
+        bool nextCandidate();
+        void advance();
+    };
+
+    /**
+     * @brief 判断参数是否为选择器
+     * @param token 命令参数
+     * @return 是否以 @e 开头
+     */
+    static bool isSelector(const std::string& token) { return token.rfind("@e", 0) == 0; }
+
+    /**
+     * @brief 解析选择器文本
+     * @param text 选择器文本
+     * @return 选择器
+     * @throws runtime_error 格式错误时抛出异常
+     */
+    static EntitySelector parse(const std::string& text);
+
+    /**
+     * @brief 在游戏世界中执行选择
+     * @param engine 游戏引擎引用
+     * @return 命中实体的惰性区间
+     */
+    Range select(GameEngine& engine) const;
+
+private:
+    /// 属性比较条件，如 prop:health<50
+    struct PropertyFilter {
+        std::string key;
+        std::string op;
+        std::string value;
+    };
+
+    std::optional<std::string> type;
+    std::optional<std::string> name;
+    std::optional<std::string> map;
+    std::optional<int> x;
+    std::optional<int> y;
+    std::optional<int> radius;
+    std::optional<std::size_t> limit;
+    std::vector<PropertyFilter> properties;
+
+    bool isSpatial() const { return radius || x || y; }
+    static std::map<std::pair<int, int>, GameObject>& objectsOf(GameMap& map) { return map.objects; }
+    bool matches(const GameObject& obj, int centerX, int centerY) const;
+    static bool compareProperty(const GameObject::PropertyValue& value, const PropertyFilter& filter);
+};
+
+/**
+ * @class EntitySelector::Range
+ * @brief 惰性结果区间，可用于范围for循环
+ *
+ * 区间持有选择器副本，可直接对parse()的临时结果调用select()
+ */
+class EntitySelector::Range {
+public:
+    Range(GameEngine& engine, EntitySelector selector) : engine(engine), selector(std::move(selector)) {}
+    Iterator begin() const { return Iterator(engine, selector); }
+    Iterator end() const { return Iterator(); }
+private:
+    GameEngine& engine;
+    EntitySelector selector;
+};
+
+inline EntitySelector::Range EntitySelector::select(GameEngine& engine) const {
+    return Range(engine, *this);
+}
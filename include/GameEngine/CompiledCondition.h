@@ -0,0 +1,50 @@
+// include/GameEngine/CompiledCondition.h
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct CompiledCondition
+ * @brief 预解析的条件或算术表达式（语法树）
+ *
+ * 条件文本只解析一次（见ConditionEvaluator::compile），之后每次求值只遍历语法树：
+ * 不分词、不拷贝字符串、不构造正则，也不分配内存。
+ * 节点存放在连续数组中，子节点以下标引用；常量子树在编译时折叠。
+ */
+struct CompiledCondition {
+    /// 节点类型
+    enum class Op : std::uint8_t {
+        CONST,     ///< 整数常量（条件中0/1表示假/真）
+        VALUE,     ///< 变量或实体计分项，见values
+        HAVE,      ///< 背包中有物品，见names
+        VISITED,   ///< 去过地点标记，见names
+        PREDICATE, ///< 插件谓词，见predicates
+        NOT, AND, OR,
+        EQ, NE, GT, LT, GE, LE,
+        ADD, SUB, MUL, DIV, MOD, NEG
+    };
+
+    struct Node {
+        Op op = Op::CONST;
+        int value = 0;          ///< CONST的值
+        std::uint32_t left = 0;  ///< 左（唯一）子节点
+        std::uint32_t right = 0; ///< 右子节点
+        std::uint32_t ref = 0;   ///< VALUE/HAVE/VISITED/PREDICATE引用的数据下标
+    };
+
+    /// 值引用：变量名，或"实体名.计分项"（预先拆分，求值时不再切分字符串）
+    struct ValueRef {
+        std::string name;      ///< 原始名称（作为变量名查找）
+        std::string entity;    ///< 实体名（名称中不含'.'时为空）
+        std::string objective; ///< 计分项
+    };
+
+    std::string source;                              ///< 源文本（用于报错）
+    bool valid = false;                              ///< 是否解析成功
+    std::uint32_t root = 0;                          ///< 根节点下标
+    std::vector<Node> nodes;
+    std::vector<ValueRef> values;                    ///< VALUE节点的引用
+    std::vector<std::string> names;                  ///< HAVE/VISITED节点的物品名、地点标记
+    std::vector<std::vector<std::string>> predicates; ///< PREDICATE节点的各部分（[0]为谓词名）
+};
@@ -1,20 +1,25 @@
 // include/ConditionEvaluator.h
 #pragma once
-#include <vector>
+#include "CompiledCondition.h"
+#include <cstddef>
 #include <string>
+#include <unordered_map>
 
 class GameEngine;
 
 /**
  * @class ConditionEvaluator
  * @brief 游戏条件评估器，负责解析和评估游戏中的各种条件表达式
- * 
+ *
  * 该类提供静态方法用于：
  * 1. 检查玩家物品持有状态
  * 2. 验证地点访问标记
  * 3. 比较游戏变量值
  * 4. 执行算术表达式计算
- * 5. 处理游戏变量替换
+ * 5. 组合条件（and、or、not、括号）
+ *
+ * 条件和表达式首次使用时编译为语法树（CompiledCondition）并按源文本缓存，
+ * 之后的求值只遍历语法树，不再解析文本。
  */
 class ConditionEvaluator {
 public:
@@ -23,46 +28,79 @@ public:
      * @param engine 游戏引擎引用，用于访问游戏状态
      * @param condition 要评估的条件字符串
      * @return 条件是否满足
-     * 
+     * @throw std::runtime_error 条件格式无效
+     *
      * 支持的条件类型：
      * - 物品持有检查: "have itemName"
      * - 地点访问检查: "去过 locationMarker"
      * - 变量相等检查: "varName is value"
      * - 通用比较表达式: "varName>=10" (支持 ==, !=, >, <, >=, <=)
+     * - 实体计分项: "guard.health<50"（实体名.计分项，可用于以上两种比较）
+     * - 插件谓词: "near_water 3"（第一个词为插件注册的谓词名，见PluginHost）
+     * - 组合: "have key and (gold>=10 or not 去过 village)"（not > and > or，短路求值）
      */
     static bool evaluate(GameEngine& engine, const std::string& condition);
-    
+
     /**
      * @brief 计算算术表达式
      * @param engine 游戏引擎引用
      * @param expr 要计算的表达式字符串
-     * @return 表达式计算结果
-     * 
+     * @return 表达式计算结果（格式无效时为0）
+     *
      * 功能特点：
-     * - 支持变量替换（{varName}格式）
-     * - 支持基本四则运算（+, -, *, /）
-     * - 自动处理空格和变量替换
+     * - 支持变量替换（{varName}、{实体名.计分项}格式，未定义时为0）
+     * - 支持四则运算、取余、负号和括号（+, -, *, /, %），除数为0时结果为0
+     * - 忽略空格
      */
     static int evaluateExpression(GameEngine& engine, const std::string& expr);
 
+    /**
+     * @brief 编译条件
+     * @param condition 条件字符串
+     * @return 语法树（格式无效时valid为false）
+     */
+    static CompiledCondition compile(const std::string& condition);
+
+    /**
+     * @brief 编译算术表达式
+     * @param expr 表达式字符串
+     * @return 语法树（格式无效时valid为false）
+     */
+    static CompiledCondition compileExpression(const std::string& expr);
+
+    /**
+     * @brief 评估已编译的条件
+     * @throw std::runtime_error 条件格式无效
+     */
+    static bool evaluate(GameEngine& engine, const CompiledCondition& condition);
+
+    /**
+     * @brief 清空编译缓存
+     *
+     * 插件注册新谓词后调用：之前编译的条件可能需要按谓词重新解析
+     */
+    static void clearCache();
+
 private:
+    static constexpr std::size_t MAX_CACHED = 4096; ///< 每种缓存的上限（超出后不再缓存新文本）
+
+    static std::unordered_map<std::string, CompiledCondition> conditionCache;  ///< 条件文本 -> 语法树
+    static std::unordered_map<std::string, CompiledCondition> expressionCache; ///< 表达式文本 -> 语法树
+
     /**
-     * @brief 分词函数
-     * @param line 输入字符串
-     * @return 分词后的字符串向量
+     * @brief 计算语法树节点
+     * @param engine 游戏引擎引用
+     * @param tree 语法树
+     * @param node 节点下标
+     * @return 节点的值（条件节点为0或1）
      */
-    static std::vector<std::string> tokenize(const std::string& line);
-    
+    static int evaluateNode(GameEngine& engine, const CompiledCondition& tree, std::uint32_t node);
+
     /**
-     * @brief 替换表达式中的变量
+     * @brief 读取变量或实体计分项的值
      * @param engine 游戏引擎引用
-     * @param expr 包含变量的原始表达式
-     * @return 变量替换后的表达式
-     * 
-     * 替换规则：
-     * - 识别 {variableName} 格式的变量
-     * - 将变量替换为其当前整数值
-     * - 未定义变量默认为0
+     * @param ref 预先拆分的名称
+     * @return 当前值（未定义时为0）
      */
-    static std::string replaceVariables(GameEngine& engine, const std::string& expr);
-};
\ No newline at end of file
+    static int lookupValue(GameEngine& engine, const CompiledCondition::ValueRef& ref);
+};
@@ -0,0 +1,92 @@
+// include/GameEngine/Console.h
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+class GameEngine;
+
+/**
+ * @class Console
+ * @brief 游戏内开发者控制台，在运行中的游戏里执行命令、查看状态
+ *
+ * 功能：
+ * - 以 / 开头的输入经CommandParser执行，与脚本中的命令相同；显示执行结果或错误
+ * - 其他输入按名称查看状态：变量、地图实体、NPC模板、物品定义或地图
+ * - Tab补全：第一个词补全命令名，第二个词补全子命令，其余补全地图名、实体名和变量名
+ * - 上下键浏览输入历史
+ *
+ * 补全数据来源：
+ * - 命令名、子命令名：注册时写入的前缀树（CommandParser、CommandTable）
+ * - 地图上的实体名：各地图随名称索引增删的前缀树（GameMap::completeName）
+ * - 地图、NPC、物品、变量、计分项：本身为有序表，按前缀二分查找
+ * 因此补全总是反映当前状态，无需重建索引。
+ */
+class Console {
+public:
+    static constexpr std::size_t MAX_OUTPUT_LINES = 200;  ///< 保留的输出行数
+    static constexpr std::size_t MAX_HISTORY = 50;        ///< 保留的输入历史条数
+    static constexpr std::size_t MAX_CANDIDATES = 64;     ///< 每个数据来源最多取的补全候选数
+
+    /**
+     * @brief 在输入末尾追加一个字节（多字节字符逐字节追加）
+     */
+    void insert(char c) { input.push_back(c); }
+
+    /**
+     * @brief 删除输入末尾的一个字符（UTF-8多字节字符整体删除）
+     */
+    void backspace();
+
+    /**
+     * @brief 执行当前输入并清空输入行
+     * @param engine 游戏引擎引用
+     *
+     * 命令作为一个批量执行，错误除写入error.log外也显示在控制台中
+     */
+    void submit(GameEngine& engine);
+
+    /**
+     * @brief 补全当前输入的最后一个词
+     * @param engine 游戏引擎引用
+     *
+     * 唯一候选时补全整个词并追加空格；多个候选时补全到公共前缀并列出候选
+     */
+    void complete(GameEngine& engine);
+
+    /**
+     * @brief 计算输入最后一个词的补全候选
+     * @param engine 游戏引擎引用
+     * @param line 输入内容
+     * @return 按字典序排列、去重的候选
+     */
+    static std::vector<std::string> candidates(GameEngine& engine, const std::string& line);
+
+    /**
+     * @brief 浏览输入历史（上一条/下一条）
+     */
+    void historyPrev();
+    void historyNext();
+
+    /**
+     * @brief 追加一行输出
+     */
+    void print(std::string line);
+
+    const std::string& getInput() const { return input; }
+    const std::deque<std::string>& getOutput() const { return output; }
+
+private:
+    std::string input;                ///< 当前输入行
+    std::deque<std::string> output;   ///< 输出（旧的在前）
+    std::vector<std::string> history; ///< 输入历史（旧的在前）
+    std::size_t historyIndex = 0;     ///< 浏览历史的位置（等于history.size()表示新输入）
+
+    /**
+     * @brief 按名称显示状态
+     * @param engine 游戏引擎引用
+     * @param name 变量、实体、NPC、物品或地图名称
+     */
+    void inspect(GameEngine& engine, const std::string& name);
+};
@@ -4,11 +4,17 @@
 #include "GameMap.h"
 #include "GameObject.h"
 #include "ConditionEvaluator.h"
+#include "Console.h"
 #include "DialogSystem.h"
 #include "InventoryManager.h"
+#include "PendingMap.h"
 #include "SaveLoadManager.h"
-#include "Renderer.h"
-#include "InputHandler.h"
+#include "Scheduler.h"
+#include "Scoreboard.h"
+#include "Script.h"
+#include "ScriptWatcher.h"
+#include "UndoJournal.h"
+#include <future>
 #include <map>
 #include <set>
 #include <vector>
@@ -32,17 +38,33 @@
 class GameEngine {
 private:
     // 游戏核心数据
-    std::map<std::string, GameMap> maps;          ///< 所有游戏地图(名称->实例)
+    std::map<std::string, GameMap> maps;          ///< 已构建的游戏地图(名称->实例)
+    std::map<std::string, PendingMapProgram> pendingMaps; ///< 尚未构建的地图(名称->构建命令)
+    std::map<std::string, std::future<GameMap>> prefetchedMaps; ///< 后台预构建中的地图
+    bool deferMapBuilding = false;                ///< 加载脚本期间记录地图构建命令而不执行
     std::map<std::string, GameObject> npcTemplates; ///< NPC模板库
     std::map<std::string, GameObject> items;      ///< 物品定义库
+    std::map<std::string, CommandProgram> itemEffects; ///< 物品名 -> 预编译的使用效果
     std::map<std::string, int> variables;         ///< 游戏变量存储
     std::set<std::string> visitedMarkers;         ///< 已访问地点标记
+    Scoreboard scoreboard;                        ///< 实体计分项（按实体ID列式存储）
+    Scheduler scheduler;                          ///< 按回合延后执行的命令
 
     // 子系统
     InventoryManager inventoryManager;            ///< 物品栏管理系统
     DialogSystem dialogSystem;                    ///< 对话系统
+    Console console;                              ///< 开发者控制台
     SaveLoadManager saveLoadManager;              ///< 存档管理系统
-    std::unique_ptr<Renderer> renderer;          ///< 渲染系统(拥有所有权)
+    std::unique_ptr<ScriptWatcher> scriptWatcher; ///< 脚本监视器(仅热重载模式)
+
+    // 脚本
+    std::string scriptFile;                       ///< 已加载的脚本路径
+    Script loadedScript;                          ///< 最近一次编译的脚本(热重载时比较差异)
+    bool strictLoading = false;                   ///< 严格加载：执行失败的块整体撤销
+    bool profiling = false;                       ///< 加载分析：统计各行、各命令的开销
+    UndoJournal* journal = nullptr;               ///< 当前事务的撤销日志(无事务时为空)
+    int batchDepth = 0;                           ///< 批量执行的嵌套深度
+    std::vector<std::string> batchMaps;           ///< 本次批量中推迟维护索引的地图
 
     // 运行时状态
     std::string currentMap = "start";             ///< 当前地图标识
@@ -54,6 +76,7 @@ private:
     int viewportY = 0;                            ///< 视口左上角Y坐标
     int viewportW = 20;                           ///< 视口宽度(格子数)
     int viewportH = 10;                           ///< 视口高度(格子数)
+    int itemInstanceCounter = 0;                  ///< 物品实例ID计数器
 
 public:
     /**
@@ -72,9 +95,29 @@ public:
      * - 必须包含init块
      * - 必须定义'main'地图
      * - 支持嵌套条件块
+     *
+     * 加载成功后在脚本旁写入快照（文件名.snap），
+     * 脚本内容未变时下次启动直接从快照恢复（见WorldSnapshot）；已加载插件时不使用快照
+     *
+     * 严格加载模式下每个块作为一个事务执行，块内有命令失败时撤销该块的全部修改；
+     * 分析模式下统计各行、各命令的开销（见setProfiling）
      */
     void loadGame(const std::string& filename);
     
+    /**
+     * @brief 设置严格加载模式（需在loadGame之前调用）
+     * @param strict 是否开启
+     */
+    void setStrictLoading(bool strict) { strictLoading = strict; }
+    
+    /**
+     * @brief 开启加载分析（需在loadGame之前调用，见LoadProfiler）
+     * @param enabled 是否开启
+     *
+     * 分析模式下总是执行脚本（不读取快照），加载结束后在脚本旁写出报告和折叠栈文件
+     */
+    void setProfiling(bool enabled) { profiling = enabled; }
+    
     /**
      * @brief 保存当前游戏状态
      * @param filename 存档文件路径
@@ -93,17 +136,80 @@ public:
      * 1. 渲染当前帧
      * 2. 处理玩家输入
      * 3. 更新游戏状态
+     *
+     * 渲染器和输入处理器只在循环期间存在。定义在GameLoop.cpp中，属于终端界面部分
+     * （GameEngineUI）；只执行脚本和命令的程序（如基准测试）不链接ncurses
      */
     void startGameLoop();
     
+    /**
+     * @brief 开启脚本热重载
+     * @throws runtime_error 无法监视脚本文件时抛出异常
+     *
+     * 开启后游戏循环定期检查脚本修改，只重新执行变化的部分（见reloadScript）
+     */
+    void enableHotReload();
+    
+    /**
+     * @brief 重新加载脚本并应用变化
+     *
+     * 处理方式：
+     * - 按类型、声明和出现次序匹配新旧顶层块，未变化的块跳过
+     * - 物品效果块：整体替换该物品的使用效果
+     * - init/if块：逐行比较，删除的setblock/fill清除对应区域，新增的命令执行一次
+     *   （if块需当前条件成立）
+     * - 玩家位置、物品栏、变量等运行状态保持不变
+     *
+     * 编译失败时记录到error.log，保持当前状态；
+     * 应用变化时有命令失败则撤销本次重载的全部修改
+     */
+    void reloadScript();
+    
+    /**
+     * @brief 以事务方式执行脚本块
+     * @param block 脚本块
+     * @return 是否提交（块内有命令失败时撤销该块的全部修改并返回false）
+     * @throws runtime_error 与executeBlock相同，抛出前先撤销
+     */
+    bool executeBlockAtomic(const ScriptBlock& block);
+    
+    /**
+     * @brief 获取当前事务的撤销日志
+     * @return 撤销日志（不在事务中时为nullptr）
+     *
+     * 命令执行前通过它记录将被修改的状态
+     */
+    UndoJournal* getJournal() { return journal; }
+    
     /**
      * @brief 执行游戏命令
      * @param tokens 已分词的命令参数
      *
-     * 注意：会触发命令解析器的完整处理流程
+     * 直接按参数编译后执行，不再拼接回文本重新分词
      */
     void runCommand(const std::vector<std::string>& tokens);
     
+    /**
+     * @brief 顺序执行预解析的命令序列（作为一个批量，见runBatch）
+     * @param program 编译后的命令序列
+     */
+    void runProgram(const CommandProgram& program);
+    
+    /**
+     * @brief 将一组命令作为一个整体执行
+     * @param commands 命令数组
+     * @param count 命令条数
+     *
+     * 执行结果与逐条执行相同，但：
+     * - 连续写同一地图的setblock/fill只查找一次地图，直接写入地图对象
+     * - 批量中写入的地图在结束时统一维护名称/类型索引（批量中按索引查询时先补齐）
+     * - 玩家位置或当前地图变化时，结束时更新一次视口
+     * - 命令错误先缓存，结束时一次写入error.log
+     *
+     * 嵌套调用并入最外层批量
+     */
+    void runBatch(const CompiledCommand* commands, size_t count);
+    
     /**
      * @brief 显示对话内容
      * @param speaker 说话者名称
@@ -130,6 +236,8 @@ public:
     const InventoryManager& getInventoryManager() const { return inventoryManager; }
     DialogSystem& getDialogSystem() { return dialogSystem; }
     const DialogSystem& getDialogSystem() const { return dialogSystem; }
+    Console& getConsole() { return console; }
+    const Console& getConsole() const { return console; }
     std::set<std::string>& getVisitedMarkers() { return visitedMarkers; }
     const std::set<std::string>& getVisitedMarkers() const { return visitedMarkers; }
     
@@ -152,13 +260,6 @@ public:
      */
     int generateItemInstanceId();
     
-    /**
-     * @brief 分词工具
-     * @param line 输入字符串
-     * @return 分词结果向量
-     */
-    std::vector<std::string> tokenize(const std::string& line);
-    
     /**
      * @brief 拾取指定位置的物品
      * @param x 地图X坐标
@@ -205,14 +306,89 @@ public:
     bool evalCondition(const std::string& condition);
     
     // 数据容器访问
-    std::map<std::string, GameMap>& getMaps() { return maps; }
+    /**
+     * @brief 获取所有地图（会先构建所有尚未构建的地图）
+     */
+    std::map<std::string, GameMap>& getMaps() { loadAllMaps(); return maps; }
+    /// 只读访问只包含已构建的地图
     const std::map<std::string, GameMap>& getMaps() const { return maps; }
+    /// 已构建的地图（不触发构建）
+    std::map<std::string, GameMap>& getLoadedMaps() { return maps; }
+    
+    /**
+     * @brief 检查地图是否存在（含尚未构建的地图）
+     * @param name 地图名称
+     */
+    bool hasMap(const std::string& name) const { return maps.count(name) > 0 || pendingMaps.count(name) > 0; }
+    
+    /**
+     * @brief 获取指定地图，尚未构建时先执行其构建命令
+     * @param name 地图名称（不存在时创建默认地图）
+     * @return 地图引用
+     */
+    GameMap& getMap(const std::string& name);
+    
+    /**
+     * @brief 构建所有尚未构建的地图
+     *
+     * 各地图的构建命令只写自己的地图、只读物品定义，多张地图并行构建
+     */
+    void loadAllMaps();
+    
+    /**
+     * @brief 加载脚本期间记录地图构建命令
+     * @param args /map 命令参数
+     * @return 是否已记录（记录后调用方不应再执行该命令）
+     *
+     * 只记录尚未构建的非主地图的 create/setblock/fill 命令
+     */
+    bool deferMapCommand(const std::vector<std::string>& args);
     std::map<std::string, GameObject>& getNpcs() { return npcTemplates; }
     std::map<std::string, GameObject>& getItems() { return items; }
     std::map<std::string, int>& getVariables() { return variables; }
     const std::map<std::string, int>& getVariables() const { return variables; }
+    Scoreboard& getScoreboard() { return scoreboard; }
+    const Scoreboard& getScoreboard() const { return scoreboard; }
+    Scheduler& getScheduler() { return scheduler; }
+    const Scheduler& getScheduler() const { return scheduler; }
+    
+    /**
+     * @brief 推进一个回合：执行到期的定时命令并通知插件（作为一个批量）
+     *
+     * 游戏循环每处理一次按键调用一次（控制台中的按键不推进回合）
+     */
+    void tick();
+    
+    /**
+     * @brief 在所有地图中按名称查找实体
+     * @param name 实体名称
+     * @return 第一个匹配的地图对象，未找到时返回nullptr
+     *
+     * 先查已构建的地图；未找到时只构建构建命令中放置了该名称实体的地图
+     */
+    GameObject* findEntity(const std::string& name);
+    
+    /**
+     * @brief 只在已构建的地图中按名称查找实体（不构建地图）
+     * @param name 实体名称
+     * @return 第一个匹配的地图对象，未找到时返回nullptr
+     */
+    GameObject* findBuiltEntity(const std::string& name);
+    
+    /**
+     * @brief 尚未构建、且构建命令中放置了该名称实体的地图
+     * @param name 实体名称
+     * @return 地图名称（按名称排序）
+     *
+     * 这些地图上的实体还没有计分（写入计分项前会先构建地图）
+     */
+    std::vector<std::string> pendingMapsWithEntity(const std::string& name) const;
     
-    InputHandler inputHandler{*this};  ///< 输入处理器(绑定当前引擎实例)
+    /**
+     * @brief 是否有尚未构建的地图放置了该名称的实体（不分配内存）
+     * @param name 实体名称
+     */
+    bool hasPendingEntity(const std::string& name) const;
     
     const std::list<GameObject>& getInventory() const { return inventoryManager.getItems(); }
         
@@ -228,6 +404,24 @@ public:
      */
     void useItem(const GameObject& item);
     
+    /**
+     * @brief 执行物品的使用效果
+     * @param item 物品实例
+     *
+     * 依次执行：
+     * - 物品效果块编译出的命令序列（加载时编译一次）
+     * - 实例上的use_effects属性（以';'分隔的命令，按文本缓存编译结果）
+     */
+    void runItemEffects(const GameObject& item);
+    
+    /**
+     * @brief 追加物品的使用效果
+     * @param itemName 物品名称
+     * @param lines 命令源码（保存在物品定义中，用于快照）
+     * @param program 对应的预编译命令
+     */
+    void addItemEffects(const std::string& itemName, const std::vector<std::string>& lines, const CommandProgram& program);
+    
     /**
      * @brief 丢弃物品到当前位置
      * @param item 要丢弃的物品实例
@@ -241,8 +435,16 @@ public:
     /**
      * @brief 切换当前地图
      * @param map 目标地图名称
+     *
+     * 首次进入时构建地图，并在后台预构建可由此到达的相邻地图；之后通知插件（进入地图事件）
      */
-    void setCurrentMap(const std::string& map) { currentMap = map; }
+    void setCurrentMap(const std::string& map);
+    
+    /**
+     * @brief 获取当前地图名称
+     * @return 当前地图标识
+     */
+    const std::string& getCurrentMapName() const { return currentMap; }
     
     /**
      * @brief 获取指定位置的对象
@@ -255,42 +457,68 @@ public:
 private:
     // 初始化方法
     /**
-     * @brief 处理init代码块
-     * @param fs 输入文件流
-     * @param lineNumber 当前行号(引用传递会修改)
+     * @brief 执行已编译的脚本块
+     * @param block 脚本块
+     *
+     * - init块：按读写集合划分批次，批内不同地图的构建命令并行执行（结果与顺序执行相同）
+     * - if块：条件成立时执行第一层命令
+     * - 物品效果块：登记到对应物品的使用效果
      *
-     * 语法格式：
-     * init {
-     *   // 初始化命令
-     * }
+     * @throws runtime_error 物品效果块引用未定义物品时抛出异常
      */
-    void processInitBlock(std::ifstream& fs, int& lineNumber);
+    void executeBlock(const ScriptBlock& block);
     
     /**
-     * @brief 处理条件代码块
-     * @param fs 输入文件流
-     * @param condition 条件表达式
-     * @param currentLine 当前行号
+     * @brief 按依赖分析并发执行命令序列
+     * @param program 命令序列
      *
-     * 语法格式：
-     * if 条件 {
-     *   // 条件成立时执行的命令
-     * }
+     * 每批中写入不同地图的命令按地图分组在工作线程执行，
+     * 其余命令同时在主线程按源顺序执行；命令较少时直接顺序执行
+     */
+    void runConcurrent(const CommandProgram& program);
+    
+    /**
+     * @brief 在事务中执行操作
+     * @param body 要执行的操作
+     * @return 是否提交（有命令失败时撤销全部修改并返回false）
+     *
+     * 已在事务中时直接执行，由外层事务决定提交或撤销
+     */
+    template<typename Body>
+    bool runTransaction(Body&& body);
+    
+    /**
+     * @brief 在批量中执行操作（见runBatch）
+     * @param body 要执行的操作
+     */
+    template<typename Body>
+    void runBatched(Body&& body);
+    
+    /**
+     * @brief 获取指定地图（getMap的实现，不登记到批量）
      */
-    void processIfBlock(std::ifstream& fs, const std::string& condition, int currentLine);
+    GameMap& resolveMap(const std::string& name);
     
     /**
-     * @brief 处理物品效果块
-     * @param fs 输入文件流
-     * @param headerLine 块声明行
-     * @param lineNumber 当前行号(引用传递会修改)
+     * @brief 清空所有地图（读档前调用）
      *
-     * 语法格式：
-     * item 使用效果 物品名: {
-     *   // 使用效果命令
-     * }
+     * 直接丢弃尚未构建的地图的构建命令，不为清空而构建；
+     * 等待后台预构建结束后丢弃其结果
+     */
+    void clearMaps();
+    
+    /**
+     * @brief 地图的构建命令当前是否应记录而不执行
+     * @param name 地图名称
      */
-    void processItemEffectBlock(std::ifstream& fs, const std::string& headerLine, int& lineNumber);
+    bool isDeferredMap(const std::string& name) const;
+    
+    /**
+     * @brief 在独立的地图对象上执行构建命令（不访问引擎状态，可在工作线程调用）
+     * @param program 该地图的构建命令（物品定义取自记录时保存的副本）
+     * @return 构建完成的地图
+     */
+    static GameMap buildDetachedMap(const PendingMapProgram& program);
 
     // 辅助方法
     /**
@@ -301,6 +529,32 @@ private:
      */
     static char dirToChar(int dx, int dy);
     
+    /**
+     * @brief 在后台线程预构建从当前地图可到达的地图
+     *
+     * 相邻地图来源：
+     * - 当前地图上对象的字符串属性值为地图名（如传送门的 target=cave）
+     * - 当前地图上NPC对话中的 /teleport 命令
+     * - 物品使用效果中的 /teleport 命令
+     */
+    void prefetchNeighbors();
+    
+    /**
+     * @brief 应用单个顶层块的变化（热重载）
+     * @param previous 旧块（新增块为nullptr）
+     * @param current 新块（删除块为nullptr）
+     */
+    void applyBlockChange(const ScriptBlock* previous, const ScriptBlock* current);
+    
+    /**
+     * @brief 清除一条setblock/fill命令放置的对象（热重载）
+     * @param args 命令参数
+     */
+    void clearMapCommand(const std::vector<std::string>& args);
+    
     friend class SaveLoadManager;     ///< 允许存档管理器访问私有数据
+    friend class WorldSnapshot;       ///< 允许快照缓存访问私有数据
+    friend class UndoJournal;         ///< 允许撤销日志记录和恢复私有数据
     friend class ConditionEvaluator; ///< 允许条件评估器访问私有数据
+    friend class Console;             ///< 允许控制台查看和补全私有数据
 };
\ No newline at end of file
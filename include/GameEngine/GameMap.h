@@ -1,8 +1,11 @@
 // include/GameEngine/GameMap.h
 #pragma once
 #include "GameObject.h"
+#include "PrefixTrie.h"
 #include <vector>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <utility>
 
 /**
@@ -16,6 +19,19 @@
  * - 支持区域填充操作
  */
 class GameMap {
+public:
+    /// 对象位置集合（按坐标有序）
+    using PositionSet = std::set<std::pair<int, int>>;
+
+    /**
+     * @struct EntityIdState
+     * @brief 全局实体ID的分配状态
+     */
+    struct EntityIdState {
+        std::uint32_t next = 1;           ///< 从未分配过的最小ID（0表示未分配）
+        std::set<std::uint32_t> released; ///< 已释放、可重新分配的ID
+    };
+
 private:
     int width;  ///< 地图宽度（单位：格子）
     int height; ///< 地图高度（单位：格子）
@@ -31,6 +47,52 @@ private:
      */
     std::map<std::pair<int, int>, GameObject> objects;
 
+    mutable std::unordered_map<std::string, PositionSet> nameIndex; ///< 名称索引：名称 -> 对象坐标
+    mutable std::unordered_map<std::string, PositionSet> typeIndex; ///< 类型索引：类型 -> 对象坐标
+    mutable PrefixTrie nameTrie;    ///< 名称索引中的名称（补全用，随名称索引增删）
+
+    bool batching = false;          ///< 批量写入中：索引维护推迟到flushIndex
+    mutable PositionSet unindexed;  ///< 批量写入期间已移出索引、尚未重新加入的坐标
+
+    /**
+     * @brief 将对象加入/移出名称和类型索引
+     * @param pos 对象坐标
+     * @param obj 游戏对象
+     */
+    void indexObject(const std::pair<int, int>& pos, const GameObject& obj) const;
+    void unindexObject(const std::pair<int, int>& pos, const GameObject& obj) const;
+
+    /**
+     * @brief 将批量写入期间改动的坐标按最终对象重新加入索引
+     *
+     * 按索引查询前调用，保证批量写入期间的查询结果与逐条写入时相同
+     */
+    void flushIndex() const;
+
+    /**
+     * @brief 读取/恢复全局实体ID分配状态（供快照和撤销日志使用）
+     */
+    static EntityIdState entityIdState();
+    static void restoreEntityIdState(EntityIdState state);
+
+    /**
+     * @brief 复制矩形区域内的所有对象（撤销日志使用）
+     * @param x1,y1,x2,y2 区域两角坐标（无需排序）
+     * @return 区域内对象的副本
+     */
+    std::vector<GameObject> copyArea(int x1, int y1, int x2, int y2) const;
+
+    /**
+     * @brief 将矩形区域恢复为指定对象（保留原实体ID）
+     * @param x1,y1,x2,y2 区域两角坐标（无需排序）
+     * @param before copyArea得到的对象副本
+     */
+    void restoreArea(int x1, int y1, int x2, int y2, const std::vector<GameObject>& before);
+
+    friend class EntitySelector; ///< 允许选择器直接遍历对象
+    friend class WorldSnapshot;  ///< 允许快照按原实体ID恢复对象
+    friend class UndoJournal;    ///< 允许撤销日志按原实体ID恢复对象
+
 public:
     /**
      * @brief 构造函数
@@ -47,7 +109,11 @@ public:
      * @param y 纵坐标
      * @param obj 要放置的游戏对象
      * 
-     * 注意：会覆盖该位置原有对象
+     * 注意：会覆盖该位置原有对象，存储的对象坐标会被设置为(x,y)。
+     * 实体ID的处理：
+     * - 原地重新放置同名同类型的对象时沿用原ID（计分保留）
+     * - obj带有已释放的ID时收回该ID（如拾取后丢回地图）；ID仍被其他对象使用时视为副本，不带ID
+     * - 被覆盖对象的ID释放，供之后分配
      */
     void setObject(int x, int y, const GameObject& obj);
     
@@ -60,12 +126,26 @@ public:
     GameObject getObject(int x, int y) const;
     
     /**
-     * @brief 移除指定位置的对象
+     * @brief 移除指定位置的对象（释放其实体ID）
      * @param x 横坐标
      * @param y 纵坐标
      */
     void removeObject(int x, int y);
     
+    /**
+     * @brief 移除所有对象并释放它们的实体ID（/map create重建地图前调用）
+     */
+    void clear();
+    
+    /**
+     * @brief 分配实体ID（优先复用已释放的最小ID）
+     * @return 新ID（非0）
+     *
+     * 实体只在首次写入计分项时分配ID（见Scoreboard::track），
+     * 计分列的长度因此只与计分过的实体数量有关
+     */
+    static std::uint32_t acquireEntityId();
+    
     // 对象查询功能
     
     /**
@@ -92,6 +172,48 @@ public:
      */
     GameObject getObjectByName(const std::string& name) const;
     
+    /**
+     * @brief 按名称查找对象（可修改）
+     * @param name 对象名称
+     * @return 对象指针，未找到时返回nullptr
+     * 
+     * 注意：不要通过返回的指针修改对象的名称、类型或坐标，
+     * 否则索引会失效（请使用setObject重新放置）
+     */
+    GameObject* findObjectByName(const std::string& name);
+    
+    /**
+     * @brief 获取指定位置的对象（可修改）
+     * @param x 横坐标
+     * @param y 纵坐标
+     * @return 对象指针，位置为空时返回nullptr
+     * 
+     * 注意：同findObjectByName，不要修改名称、类型或坐标
+     */
+    GameObject* findObject(int x, int y);
+    
+    /**
+     * @brief 通过名称索引获取对象坐标
+     * @param name 对象名称
+     * @return 坐标集合指针，无此名称时返回nullptr
+     */
+    const PositionSet* positionsByName(const std::string& name) const;
+    
+    /**
+     * @brief 通过类型索引获取对象坐标
+     * @param type 对象类型
+     * @return 坐标集合指针，无此类型时返回nullptr
+     */
+    const PositionSet* positionsByType(const std::string& type) const;
+    
+    /**
+     * @brief 按前缀列出地图上的对象名称（控制台补全）
+     * @param prefix 名称前缀
+     * @param limit 最多返回的个数
+     * @return 按字典序排列的名称
+     */
+    std::vector<std::string> completeName(std::string_view prefix, std::size_t limit) const;
+    
     // 地形功能
     
     /**
@@ -142,4 +264,23 @@ public:
      * - 设置对象的正确坐标位置
      */
     void fillArea(int x1, int y1, int x2, int y2, const GameObject& templateObj);
+    
+    /**
+     * @brief 开始批量写入
+     *
+     * 批量写入期间同一坐标只在首次写入时移出索引，
+     * 其后的覆盖写入不再维护索引，结束时按最终对象统一加入
+     * （如先填充墙壁再在内部填充地面，内部格子的墙壁不会进入索引）
+     */
+    void beginBatch() { batching = true; }
+    
+    /**
+     * @brief 结束批量写入并补齐索引（未在批量中时无操作）
+     */
+    void endBatch();
+    
+    /**
+     * @brief 是否处于批量写入中
+     */
+    bool isBatching() const { return batching; }
 };
\ No newline at end of file
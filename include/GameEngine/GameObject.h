@@ -1,6 +1,9 @@
 // include/GameEngine/GameObject.h
 #pragma once
+#include "GlyphTable.h"
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <map>
 #include <vector>
 #include <variant> // 用于多类型属性值
@@ -20,9 +23,10 @@ public:
     // 基本属性
     int x = 0;             ///< 对象在地图上的横坐标
     int y = 0;             ///< 对象在地图上的纵坐标
-    char display = ' ';    ///< 对象在游戏地图上的显示字符
+    GlyphId display = ' '; ///< 对象在游戏地图上的显示字形ID（见GlyphTable）
     std::string name;      ///< 对象的唯一标识名称
     std::string type;      ///< 对象类型（如"npc", "item", "wall"等）
+    std::uint32_t entityId = 0; ///< 计分用的实体ID（首次写入计分项时分配，0表示未分配）
     
     /**
      * @brief 属性值类型（支持多种数据类型）
@@ -126,15 +130,27 @@ public:
     
     /**
      * @brief 设置显示字符
-     * @param c 代表对象的字符
+     * @param c 代表对象的ASCII字符
      */
-    void setDisplay(char c) { display = c; }
+    void setDisplay(char c) { display = static_cast<GlyphId>(c); }
     
     /**
-     * @brief 获取显示字符
-     * @return 当前显示字符
+     * @brief 设置显示字形
+     * @param text UTF-8文本，取第一个字素簇（支持中文和emoji）
      */
-    char getDisplay() const { return display; }
+    void setDisplay(std::string_view text) { display = GlyphTable::intern(text); }
+    
+    /**
+     * @brief 获取显示字形ID
+     * @return 当前显示字形ID
+     */
+    GlyphId getDisplay() const { return display; }
+    
+    /**
+     * @brief 获取显示字形的UTF-8文本
+     * @return 字形文本
+     */
+    const std::string& getDisplayText() const { return GlyphTable::get(display).text; }
     
     /**
      * @brief 格式化显示所有属性
@@ -12,12 +12,14 @@
  * - INVENTORY: 背包模式 - 玩家查看和管理背包物品
  * - ITEM_OPTION: 物品操作模式 - 玩家对选定物品执行操作
  * - DIALOG: 对话模式 - 玩家与NPC对话或查看系统消息
+ * - CONSOLE: 控制台模式 - 开发者输入命令、查看状态（不推进回合）
  */
 enum class GameState {
     EXPLORING,    ///< 探索模式（默认状态）
     INVENTORY,    ///< 背包查看模式
     ITEM_OPTION,  ///< 物品选项操作模式
-    DIALOG        ///< 对话显示模式
+    DIALOG,       ///< 对话显示模式
+    CONSOLE       ///< 开发者控制台模式
 };
 
 /**
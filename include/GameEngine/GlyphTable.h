@@ -0,0 +1,72 @@
+// include/GameEngine/GlyphTable.h
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/// 字形ID（GlyphTable中的索引，0-127 与ASCII字符一一对应）
+using GlyphId = std::uint16_t;
+
+/**
+ * @struct Glyph
+ * @brief 驻留的显示字形
+ *
+ * 每个字形对应一个完整的字素簇（如 "⚔️"、"商"、"é"），
+ * 在驻留时拆分码点并计算好显示宽度；终端字符单元由渲染器按需构建（见Renderer）。
+ */
+struct Glyph {
+    std::string text;  ///< 字素簇的UTF-8编码
+    int width = 1;     ///< 终端显示宽度（1或2列）
+    std::u32string codepoints; ///< 字素簇的各个码点
+};
+
+/**
+ * @class GlyphTable
+ * @brief 全局字形驻留表
+ *
+ * 功能特点：
+ * - 相同字素簇只存储一次，对象只保存16位字形ID
+ * - ASCII字符的ID等于其字符码，无需查表
+ * - 驻留操作线程安全，已发布的字形可无锁读取
+ */
+class GlyphTable {
+public:
+    static GlyphTable& getInstance() {
+        static GlyphTable instance;
+        return instance;
+    }
+
+    /**
+     * @brief 驻留文本中的第一个字素簇
+     * @param text UTF-8文本（多余内容会被忽略）
+     * @return 字形ID，空文本返回空格
+     * @throws runtime_error 字形数量超过上限时抛出异常
+     */
+    static GlyphId intern(std::string_view text);
+
+    /**
+     * @brief 按ID获取字形
+     * @param id 字形ID
+     * @return 字形常量引用（无效ID返回 '?'）
+     */
+    static const Glyph& get(GlyphId id);
+
+private:
+    static constexpr std::size_t CHUNK_SIZE = 256;   ///< 每块字形数量
+    static constexpr std::size_t MAX_GLYPHS = 65536; ///< GlyphId可表示的上限
+
+    GlyphTable();
+    GlyphId internImpl(std::string_view cluster);
+    Glyph& slot(std::size_t id) { return chunks[id / CHUNK_SIZE][id % CHUNK_SIZE]; }
+
+    /// 分块存储，扩容时已有字形地址不变，读取无需加锁
+    std::array<std::unique_ptr<Glyph[]>, MAX_GLYPHS / CHUNK_SIZE> chunks;
+    std::atomic<std::size_t> count{0};
+    std::unordered_map<std::string, GlyphId> index; ///< 字素簇 -> ID
+    std::mutex mutex;
+};
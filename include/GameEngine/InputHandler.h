@@ -29,6 +29,7 @@ public:
      * - 背包状态 → handleInventory()
      * - 物品操作状态 → handleItemOption()
      * - 对话状态 → handleDialog()
+     * - 控制台状态 → handleConsole()
      */
     void processInput(int key);
 
@@ -44,6 +45,7 @@ private:
      * - 'g': 拾取当前物品
      * - 'u': 与NPC对话
      * - 'i': 打开背包
+     * - '`': 打开控制台
      * - 'q': 退出游戏
      */
     void handleExploring(int key);
@@ -80,6 +82,20 @@ private:
      */
     void handleDialog(int key);
     
+    /**
+     * @brief 处理控制台状态输入
+     * @param key 按下的键值
+     * 
+     * 支持操作：
+     * - 字符键: 输入
+     * - 回车: 执行输入的命令
+     * - Tab: 补全
+     * - 上下键: 浏览输入历史
+     * - 退格: 删除一个字符
+     * - ESC或'`': 关闭控制台
+     */
+    void handleConsole(int key);
+    
     /**
      * @brief 处理移动逻辑
      * @param dx X轴移动方向（-1/0/1）
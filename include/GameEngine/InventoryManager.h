@@ -56,7 +56,7 @@ public:
      * @param engine 游戏引擎引用
      * 
      * 使用流程：
-     * 1. 执行物品的"use_effects"属性中的命令
+     * 1. 执行物品的使用效果（见GameEngine::runItemEffects）
      * 2. 消耗品减少数量（数量为0时移除）
      */
     void useItem(GameObject& item, GameEngine& engine);
@@ -121,4 +121,7 @@ private:
      * @param newItem 新添加的物品
      */
     void mergeStackable(GameObject& newItem);
+
+    friend class WorldSnapshot; ///< 允许快照恢复实例ID计数器
+    friend class UndoJournal;   ///< 允许撤销日志恢复物品栏
 };
\ No newline at end of file
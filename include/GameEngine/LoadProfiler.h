@@ -0,0 +1,154 @@
+// include/GameEngine/LoadProfiler.h
+#pragma once
+#include "CompiledCommand.h"
+#include "Script.h"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+/**
+ * @class LoadProfiler
+ * @brief 脚本加载分析器（--profile模式）
+ *
+ * 加载期间按源码行、命令类型和加载阶段统计：
+ * - 墙钟耗时
+ * - 内存分配次数（按线程统计；需链接AllocationCounter.cpp替换全局operator new，
+ *   基准测试总是链接，游戏本体只在以GAME_COUNT_ALLOCATIONS构建时链接，否则恒为0）
+ * - 地图对象写入次数（放置、替换、移除）
+ *
+ * 嵌套执行的命令（如选择器展开、对话触发的命令）计入最外层命令。
+ * 加载结束后在脚本旁写出：
+ * - 脚本路径 + ".profile.txt"：按耗时排序的报告
+ * - 脚本路径 + ".folded"：折叠栈文件（脚本;块;行;命令 纳秒），可直接生成火焰图
+ *
+ * 分析期间不读取快照、不延迟构建地图、不并发执行，保证每条命令的开销都计入其所在行。
+ */
+class LoadProfiler {
+public:
+    /// 一组统计数据
+    struct Sample {
+        std::uint64_t count = 0;       ///< 执行次数
+        std::uint64_t nanos = 0;       ///< 总耗时（纳秒）
+        std::uint64_t allocations = 0; ///< 内存分配次数
+        std::uint64_t writes = 0;      ///< 地图对象写入次数
+    };
+
+    /// 当前线程的累计计数（只增不减，统计时取差值）
+    struct Counters {
+        std::uint64_t allocations = 0;
+        std::uint64_t writes = 0;
+    };
+
+    static LoadProfiler& getInstance() {
+        static LoadProfiler instance;
+        return instance;
+    }
+
+    /**
+     * @brief 当前线程的累计计数
+     */
+    static Counters& counters() { return threadCounters; }
+
+    /// 是否链接了分配计数（由AllocationCounter.cpp在静态初始化时设置）
+    static inline bool allocationsCounted = false;
+
+    /**
+     * @brief 记录一次地图对象写入
+     */
+    static void countObjectWrite() { ++threadCounters.writes; }
+
+    /**
+     * @brief 是否处于分析会话中
+     */
+    bool isActive() const { return active; }
+
+    /**
+     * @class Session
+     * @brief 一次加载的分析会话（析构时写出报告）
+     */
+    class Session {
+    public:
+        /**
+         * @param scriptFile 脚本路径
+         * @param enabled 是否开启分析（关闭时不做任何事）
+         */
+        Session(const std::string& scriptFile, bool enabled);
+        ~Session();
+
+        Session(const Session&) = delete;
+        Session& operator=(const Session&) = delete;
+
+    private:
+        bool enabled;
+    };
+
+    /**
+     * @class Phase
+     * @brief 统计一个加载阶段（编译、执行一个块、写入快照等，阶段不嵌套）
+     */
+    class Phase {
+    public:
+        explicit Phase(std::string name);
+        /// 执行一个脚本块（阶段名为块声明和行号）
+        explicit Phase(const ScriptBlock& block);
+        ~Phase();
+
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+    private:
+        bool enabled;
+        std::chrono::steady_clock::time_point start;
+        Counters before;
+        std::uint64_t commandNanos; ///< 开始时的命令总耗时（用于计算阶段自身耗时）
+
+        void open(std::string name);
+    };
+
+    /**
+     * @class CommandScope
+     * @brief 统计一条命令的执行（只有最外层命令计数）
+     */
+    class CommandScope {
+    public:
+        explicit CommandScope(const CompiledCommand& command);
+        ~CommandScope();
+
+        CommandScope(const CommandScope&) = delete;
+        CommandScope& operator=(const CommandScope&) = delete;
+
+    private:
+        const CompiledCommand* command; ///< 不计数时为nullptr
+        std::chrono::steady_clock::time_point start;
+        Counters before;
+    };
+
+private:
+    LoadProfiler() = default;
+
+    /// 源码行的统计（附带该行的命令文本）
+    struct LineSample {
+        Sample sample;
+        std::string text;
+    };
+
+    static thread_local Counters threadCounters;
+    static thread_local int commandDepth;
+
+    bool active = false;
+    std::string scriptFile;
+    std::string phase;                            ///< 当前阶段（折叠栈的第二层）
+    std::map<std::string, Sample> phases;         ///< 阶段 -> 统计
+    std::map<std::string, Sample> commandTypes;   ///< 命令类型 -> 统计
+    std::map<int, LineSample> lines;              ///< 源码行 -> 统计
+    std::map<std::string, std::uint64_t> folded;  ///< 折叠栈 -> 纳秒
+    Sample total;                                 ///< 所有最外层命令的合计
+    std::chrono::steady_clock::time_point sessionStart;
+
+    void begin(const std::string& file);
+    void end();
+    void recordCommand(const CompiledCommand& command, const Sample& sample);
+    void writeReport(std::uint64_t sessionNanos) const;
+    void writeFolded() const;
+};
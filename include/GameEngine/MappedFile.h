@@ -0,0 +1,37 @@
+// include/GameEngine/MappedFile.h
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @class MappedFile
+ * @brief 只读内存映射文件
+ *
+ * POSIX平台使用mmap映射整个文件，内容由页缓存直接提供，不经过流缓冲区复制；
+ * 其他平台退化为一次性读入内存。对象不可复制，析构时解除映射。
+ */
+class MappedFile {
+public:
+    /**
+     * @brief 打开并映射文件
+     * @param filename 文件路径
+     * @throws runtime_error 文件无法打开或映射失败时抛出异常
+     */
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief 获取文件内容
+     * @return 指向映射内存的只读视图（生命周期与本对象相同）
+     */
+    std::string_view view() const { return {data, size}; }
+
+private:
+    const char* data = nullptr;
+    std::size_t size = 0;
+    std::string buffer; ///< 不支持mmap时的文件内容
+};
@@ -0,0 +1,22 @@
+// include/GameEngine/PendingMap.h
+#pragma once
+#include "CompiledCommand.h"
+#include "GameObject.h"
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @struct PendingMapCommand
+ * @brief 加载期间记录、首次进入地图时才执行的地图构建命令
+ *
+ * 放置物品（type=item）的命令同时保存记录时的物品定义，
+ * 之后重新定义或修改物品不影响该命令，构建结果与按顺序执行一致。
+ */
+struct PendingMapCommand {
+    CompiledCommand command;
+    std::map<std::string, GameObject> items; ///< 放置的物品定义（不放置物品时为空）
+};
+
+/// 一张待构建地图的全部构建命令（按记录顺序）
+using PendingMapProgram = std::vector<PendingMapCommand>;
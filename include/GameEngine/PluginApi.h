@@ -0,0 +1,122 @@
+// include/GameEngine/PluginApi.h
+#pragma once
+
+/**
+ * @file PluginApi.h
+ * @brief 原生插件的C接口（插件只需包含本文件，不依赖引擎的C++头文件）
+ *
+ * 插件是启动时用dlopen加载的共享库，需导出：
+ * - game_plugin_abi_version：返回编译时的 GAME_PLUGIN_ABI_VERSION
+ * - game_plugin_init：注册命令、条件谓词和事件处理函数，返回0表示成功
+ * - game_plugin_shutdown（可选）：程序退出时调用
+ *
+ * 注册只能在 game_plugin_init 中进行；初始化失败时该插件的注册全部作废。
+ * 回调均在游戏主线程执行，可通过 GamePluginApi 中的函数直接读写引擎状态。
+ * 接口返回的字符串在引擎状态下次修改前有效，需要保留时请自行复制。
+ *
+ * 兼容性约定：GamePluginApi 只在末尾追加函数，追加时 size 增大；
+ * 删除或修改已有函数、回调签名时递增 GAME_PLUGIN_ABI_VERSION。
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GAME_PLUGIN_ABI_VERSION 1u
+
+#if defined(_WIN32)
+#define GAME_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define GAME_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief 引擎实例（不透明句柄） */
+typedef struct GameEngineHandle GameEngineHandle;
+
+/** @brief 插件的注册上下文（不透明句柄，只在 game_plugin_init 期间有效） */
+typedef struct GamePluginContext GamePluginContext;
+
+/** @brief 插件可订阅的引擎事件 */
+typedef enum GamePluginEvent {
+    GAME_PLUGIN_EVENT_TICK = 0,      /**< 每回合（每次按键）一次，subject为空字符串 */
+    GAME_PLUGIN_EVENT_MAP_ENTER = 1, /**< 切换到地图，subject为地图名 */
+    GAME_PLUGIN_EVENT_ITEM_USE = 2,  /**< 使用物品（效果执行前），subject为物品名 */
+    GAME_PLUGIN_EVENT_NPC_TALK = 3,  /**< 与NPC对话（显示对话前），subject为NPC名 */
+    GAME_PLUGIN_EVENT_COUNT
+} GamePluginEvent;
+
+/**
+ * @brief 命令处理函数
+ * @param engine 引擎句柄
+ * @param argc 参数个数
+ * @param argv 参数（argv[0]为命令名，选择器已展开为实体名）
+ * @param userData 注册时传入的指针
+ * @return NULL表示成功；失败时返回错误信息（调用返回前保持有效即可）
+ */
+typedef const char* (*GamePluginCommandFn)(GameEngineHandle* engine, int argc, const char* const* argv, void* userData);
+
+/**
+ * @brief 条件谓词，用于 if 块和条件对话，如 "near_water 3"、"near_water 3 and have rod"
+ * @param argv 谓词所在的基本条件按空白切分后的各部分（argv[0]为谓词名，不含and/or/not连接的其他部分）
+ * @return 非0表示条件成立
+ */
+typedef int (*GamePluginPredicateFn)(GameEngineHandle* engine, int argc, const char* const* argv, void* userData);
+
+/**
+ * @brief 事件处理函数
+ * @param event 事件类型（GamePluginEvent）
+ * @param subject 事件对象名称（见GamePluginEvent）
+ */
+typedef void (*GamePluginEventFn)(GameEngineHandle* engine, int event, const char* subject, void* userData);
+
+/**
+ * @struct GamePluginApi
+ * @brief 引擎提供给插件的函数表
+ *
+ * 返回int的查询函数：找到时返回1并写入输出参数，否则返回0。
+ * 修改状态的函数在事务（严格加载、热重载）中会记录原值，事务失败时一并撤销。
+ */
+typedef struct GamePluginApi {
+    uint32_t abiVersion; /**< 引擎的 GAME_PLUGIN_ABI_VERSION */
+    uint32_t size;       /**< sizeof(GamePluginApi)，使用新增函数前应检查 */
+
+    /* 注册：成功返回0；名称已被占用、参数无效或不在初始化期间时返回-1 */
+    int (*registerCommand)(GamePluginContext* context, const char* name, GamePluginCommandFn fn, void* userData);
+    int (*registerPredicate)(GamePluginContext* context, const char* name, GamePluginPredicateFn fn, void* userData);
+    int (*registerEventHandler)(GamePluginContext* context, int event, GamePluginEventFn fn, void* userData);
+
+    /* 全局变量 */
+    int (*getVariable)(GameEngineHandle* engine, const char* name, int* value);
+    void (*setVariable)(GameEngineHandle* engine, const char* name, int value);
+
+    /* 地图实体（按名称查找，与条件中的"实体名.计分项"一致） */
+    int (*getScore)(GameEngineHandle* engine, const char* entity, const char* objective, int* value);
+    int (*setScore)(GameEngineHandle* engine, const char* entity, const char* objective, int value);
+    int (*getEntityInt)(GameEngineHandle* engine, const char* entity, const char* key, int* value); /**< 整数属性，字符串属性按整数解析 */
+    int (*setEntityInt)(GameEngineHandle* engine, const char* entity, const char* key, int value);
+    int (*getEntityPosition)(GameEngineHandle* engine, const char* entity, int* x, int* y);
+
+    /* 玩家与当前地图 */
+    void (*getPlayerPosition)(GameEngineHandle* engine, int* x, int* y);
+    void (*setPlayerPosition)(GameEngineHandle* engine, int x, int y);
+    const char* (*getCurrentMap)(GameEngineHandle* engine);
+    const char* (*getObjectType)(GameEngineHandle* engine, int x, int y); /**< 当前地图该位置对象的类型，无对象时返回NULL */
+    int (*isWalkable)(GameEngineHandle* engine, int x, int y);
+    int (*hasItem)(GameEngineHandle* engine, const char* item);
+
+    /* 执行一行命令（与脚本中的命令相同）；记录一条错误到error.log */
+    void (*runCommand)(GameEngineHandle* engine, const char* line);
+    void (*reportError)(GameEngineHandle* engine, const char* message);
+} GamePluginApi;
+
+/* 插件导出的入口 */
+GAME_PLUGIN_EXPORT uint32_t game_plugin_abi_version(void);
+GAME_PLUGIN_EXPORT int game_plugin_init(const GamePluginApi* api, GamePluginContext* context);
+GAME_PLUGIN_EXPORT void game_plugin_shutdown(void);
+
+#ifdef __cplusplus
+}
+#endif
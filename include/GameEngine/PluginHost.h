@@ -0,0 +1,121 @@
+// include/GameEngine/PluginHost.h
+#pragma once
+#include "PluginApi.h"
+#include <array>
+#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class GameEngine;
+
+/**
+ * @class PluginHost
+ * @brief 原生插件的加载与回调分派（插件接口见PluginApi.h）
+ *
+ * 启动时用dlopen加载插件，调用其game_plugin_init注册：
+ * - 命令：注册到CommandParser，与内置命令一样编译、执行、展开选择器（不能覆盖已有命令）
+ * - 条件谓词：条件的第一个词为谓词名时调用（见ConditionEvaluator::evaluate）
+ * - 事件处理函数：引擎在回合推进、切换地图、使用物品、与NPC对话时调用
+ *
+ * 插件加载后不再卸载（注册的回调在整个运行期间有效）。
+ * 插件可能在命令中维护自己的状态，有插件时不读写世界快照（见GameEngine::loadGame）。
+ */
+class PluginHost {
+public:
+    static PluginHost& getInstance() {
+        static PluginHost instance;
+        return instance;
+    }
+
+    /**
+     * @brief 脚本对应的插件目录
+     * @param scriptFile 脚本路径
+     * @return 与脚本同一目录下的plugins目录（不依赖当前工作目录）
+     */
+    static std::string directoryFor(const std::string& scriptFile);
+
+    /**
+     * @brief 加载一个插件
+     * @param path 共享库路径
+     * @return 是否加载并初始化成功（成功时记录插件路径，失败原因记录到error.log）
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief 加载目录下的所有插件（按文件名顺序）
+     * @param directory 插件目录（不存在时忽略）
+     * @return 成功加载的插件数
+     */
+    int loadDirectory(const std::string& directory);
+
+    /**
+     * @brief 是否已加载插件
+     */
+    bool empty() const { return modules.empty(); }
+
+    /**
+     * @brief 已加载插件的路径（按加载顺序）
+     */
+    std::vector<std::string> loadedPaths() const;
+
+    /**
+     * @brief 分派事件
+     * @param engine 游戏引擎引用
+     * @param event 事件类型
+     * @param subject 事件对象名称
+     *
+     * 没有处理函数时只做一次数组访问
+     */
+    void dispatch(GameEngine& engine, GamePluginEvent event, const std::string& subject) const {
+        if (!handlers[event].empty()) dispatchSlow(engine, event, subject);
+    }
+
+    /**
+     * @brief 按插件谓词评估条件
+     * @param engine 游戏引擎引用
+     * @param parts 条件按空白切分后的各部分（parts[0]为谓词名）
+     * @return 评估结果；不是插件谓词时为空
+     */
+    std::optional<bool> evaluatePredicate(GameEngine& engine, const std::vector<std::string>& parts) const;
+
+    /**
+     * @brief 是否已注册该谓词（条件编译时据此识别谓词）
+     */
+    bool hasPredicate(const std::string& name) const { return predicates.count(name) > 0; }
+
+    ~PluginHost();
+
+private:
+    template<typename Fn>
+    struct Callback {
+        Fn fn;
+        void* userData;
+    };
+    using Predicate = Callback<GamePluginPredicateFn>;
+    using EventHandler = Callback<GamePluginEventFn>;
+
+    // 一个已加载的插件；初始化期间的注册先暂存，初始化成功后才生效
+    struct Module {
+        std::string path;
+        void* handle = nullptr;
+        void (*shutdown)() = nullptr;
+        bool initializing = false;
+        std::vector<std::pair<std::string, Callback<GamePluginCommandFn>>> commands;
+        std::vector<std::pair<std::string, Predicate>> predicates;
+        std::vector<std::pair<int, EventHandler>> handlers;
+    };
+
+    PluginHost() = default;
+
+    std::list<Module> modules; ///< 已加载的插件（地址作为注册上下文，不能移动）
+    std::unordered_map<std::string, Predicate> predicates; ///< 谓词名 -> 回调
+    std::array<std::vector<EventHandler>, GAME_PLUGIN_EVENT_COUNT> handlers; ///< 按事件类型
+
+    void dispatchSlow(GameEngine& engine, GamePluginEvent event, const std::string& subject) const;
+    void commit(Module& module);
+
+    static const GamePluginApi API; ///< 提供给插件的函数表
+    friend struct PluginApiImpl;
+};
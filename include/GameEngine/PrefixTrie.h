@@ -0,0 +1,73 @@
+// include/GameEngine/PrefixTrie.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @class PrefixTrie
+ * @brief 字符串前缀树，用于名称补全
+ *
+ * 按字节建树，子节点按无符号字节序排列，补全结果与std::string的字典序一致。
+ * 同一个词可插入多次（计数），计数减为0时移除。
+ * 节点存放在连续数组中；移除的分支先断开，失效节点过半时整体重建。
+ */
+class PrefixTrie {
+public:
+    PrefixTrie() : nodes(1) {}
+
+    /**
+     * @brief 插入一个词（已存在时计数加一）
+     */
+    void insert(std::string_view word);
+
+    /**
+     * @brief 移除一个词（计数减一，不存在时忽略）
+     */
+    void erase(std::string_view word);
+
+    /**
+     * @brief 检查词是否存在
+     */
+    bool contains(std::string_view word) const;
+
+    /**
+     * @brief 不同词的个数
+     */
+    std::size_t size() const { return nodes[0].words; }
+
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief 列出以prefix开头的词
+     * @param prefix 前缀（空串列出全部）
+     * @param limit 最多返回的个数
+     * @return 按字典序排列的词
+     */
+    std::vector<std::string> complete(std::string_view prefix,
+                                      std::size_t limit = std::numeric_limits<std::size_t>::max()) const;
+
+private:
+    struct Node {
+        std::vector<std::pair<unsigned char, std::uint32_t>> children; ///< 按字节有序
+        std::uint32_t count = 0; ///< 以该节点结尾的词的插入次数
+        std::uint32_t words = 0; ///< 子树中不同词的个数
+    };
+
+    std::vector<Node> nodes; ///< nodes[0]为根
+    std::size_t deadNodes = 0; ///< 已断开、等待重建回收的节点数
+
+    /**
+     * @brief 查找前缀对应的节点
+     * @return 节点下标，不存在时返回nodes.size()
+     */
+    std::size_t find(std::string_view prefix) const;
+
+    void collect(std::size_t node, std::string& word, std::size_t limit, std::vector<std::string>& out) const;
+    std::size_t subtreeSize(std::size_t node) const;
+    void rebuild();
+};
@@ -3,6 +3,8 @@
 #include "GameMap.h"
 #include "GameObject.h"
 #include "DialogSystem.h"
+#include "Console.h"
+#include "GlyphTable.h"
 #include <list>
 #include <vector>
 #include <ncurses.h>
@@ -30,6 +32,14 @@ class Renderer {
     int viewportY;      ///< 视口左上角在地图上的Y坐标
     int viewportW;      ///< 视口宽度（字符数）
     int viewportH;      ///< 视口高度（字符数）
+    bool screenActive = false; ///< 终端是否已初始化
+    
+    /// 字形对应的终端字符单元
+    struct Cell {
+        cchar_t cell{};
+        int width = 0; ///< 显示宽度（0表示尚未构建）
+    };
+    std::vector<Cell> cells; ///< 按字形ID缓存的字符单元（首次绘制时构建）
     
     // 颜色对定义
     const int COLOR_PAIR_DEFAULT = 1;    ///< 默认颜色对（白底黑字）
@@ -43,19 +53,20 @@ public:
     /**
      * @brief 构造函数
      * 
-     * 初始化ncurses屏幕和颜色设置
+     * 不接管终端，进入游戏循环时才调用initScreen()，
+     * 因此只加载脚本、执行命令的程序（如基准测试）无需终端
      */
     Renderer();
     
     /**
      * @brief 析构函数
      * 
-     * 清理ncurses资源
+     * 已初始化终端时清理ncurses资源
      */
     ~Renderer();
     
     /**
-     * @brief 初始化ncurses屏幕
+     * @brief 初始化ncurses屏幕和颜色设置
      */
     void initScreen();
     
@@ -137,6 +148,13 @@ private:
      */
     void drawMapContent(const GameEngine& engine, int mapStartX, int mapStartY);
     
+    /**
+     * @brief 获取字形的终端字符单元（首次使用时构建并缓存）
+     * @param id 字形ID
+     * @return 字符单元（终端无法显示该字形时为 '?'，宽度为1）
+     */
+    const Cell& cellOf(GlyphId id);
+    
     // ================= UI渲染 =================
     
     /**
@@ -146,6 +164,7 @@ private:
      * 根据游戏状态绘制：
      * - 对话状态: 对话框
      * - 背包状态: 物品栏
+     * - 控制台状态: 控制台
      */
     void drawUI(const GameEngine& engine);
     
@@ -160,6 +179,14 @@ private:
      */
     void drawDialog(const Dialog& dialog);
     
+    /**
+     * @brief 绘制控制台
+     * @param console 控制台
+     * 
+     * 在屏幕下部显示最近的输出和当前输入行
+     */
+    void drawConsole(const Console& console);
+    
     /**
      * @brief 绘制物品栏
      * @param inventory 物品列表
@@ -0,0 +1,121 @@
+// include/GameEngine/Scheduler.h
+#pragma once
+#include "CompiledCommand.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class Scheduler
+ * @brief 按回合延后执行命令的定时器（分层时间轮）
+ *
+ * 时间轮共6层，每层64个槽，第n层的一个槽覆盖64^n个回合：
+ * - 添加：按剩余回合数直接放入对应层的槽，O(1)
+ * - 取消：定时器在槽内的双向链表中，按名称找到后直接摘除，O(1)
+ * - 推进：每回合只处理第0层的一个槽；第0层转满一圈时，把上一层的下一个槽
+ *   重新分配到下层（每个定时器最多下移5次），均摊O(1)
+ *
+ * 同一回合到期的定时器按添加顺序执行。定时器以名称标识，
+ * 同名添加会替换原定时器（热重载重复执行同一行时不会重复定时）。
+ */
+class Scheduler {
+public:
+    /// 定时器信息（列表显示用）
+    struct TimerInfo {
+        std::string name;
+        std::uint64_t remaining;        ///< 距下次执行的回合数
+        std::uint32_t interval;         ///< 重复间隔（0表示只执行一次）
+        const CompiledCommand* command; ///< 要执行的命令
+    };
+
+    /// 单个定时器的完整状态（撤销日志用，命令与调度器共享不拷贝）
+    struct Timer {
+        std::uint64_t expires;   ///< 到期回合
+        std::uint32_t interval;  ///< 重复间隔
+        std::uint64_t sequence;  ///< 添加序号（决定同一回合的执行顺序）
+        std::shared_ptr<const CompiledCommand> command;
+    };
+
+    Scheduler();
+
+    /**
+     * @brief 添加定时器（同名定时器先取消）
+     * @param name 定时器名称
+     * @param delay 延后的回合数（至少为1）
+     * @param interval 首次执行后每隔多少回合重复（0表示只执行一次）
+     * @param command 要执行的命令
+     */
+    void schedule(const std::string& name, std::uint32_t delay, std::uint32_t interval, CompiledCommand command);
+
+    /**
+     * @brief 取消定时器
+     * @param name 定时器名称
+     * @return 定时器是否存在
+     */
+    bool cancel(const std::string& name);
+
+    /**
+     * @brief 取得定时器的当前状态
+     * @param name 定时器名称
+     * @return 定时器状态（不存在时为空）
+     */
+    std::optional<Timer> find(const std::string& name) const;
+
+    /**
+     * @brief 将定时器恢复为之前取得的状态
+     * @param name 定时器名称
+     * @param timer find的结果（为空时取消该定时器）
+     *
+     * 保留原到期回合和添加序号，恢复后与从未修改过一样
+     */
+    void restore(const std::string& name, const std::optional<Timer>& timer);
+
+    /**
+     * @brief 推进一个回合，执行到期的定时器
+     * @param run 执行命令的回调
+     *
+     * 命令可以添加或取消定时器（包括自身）；本回合到期但尚未执行的定时器被取消时不再执行
+     */
+    void advance(const std::function<void(const CompiledCommand&)>& run);
+
+    /**
+     * @brief 按添加顺序列出所有定时器
+     */
+    std::vector<TimerInfo> list() const;
+
+    std::size_t size() const { return byName.size(); }
+    std::uint64_t getTick() const { return tick; }
+
+private:
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr int LEVELS = 6;                       ///< 覆盖2^36个回合，大于最大延迟
+    static constexpr int SLOTS = 1 << LEVEL_BITS;          ///< 每层槽数
+    static constexpr std::uint32_t SENTINELS = LEVELS * SLOTS; ///< 每个槽一个链表头结点
+
+    /// 定时器结点（下标小于SENTINELS的是各槽的链表头）
+    struct Node {
+        std::uint32_t prev = 0;
+        std::uint32_t next = 0;
+        std::uint64_t sequence = 0;  ///< 添加序号（0表示空闲）
+        std::uint64_t expires = 0;   ///< 到期回合
+        std::uint32_t interval = 0;
+        std::string name;
+        std::shared_ptr<const CompiledCommand> command; ///< 执行中被取消时由执行方继续持有
+    };
+
+    std::vector<Node> nodes;
+    std::vector<std::uint32_t> freeNodes;
+    std::unordered_map<std::string, std::uint32_t> byName; ///< 名称 -> 结点下标
+    std::uint64_t tick = 0;                                ///< 已推进的回合数
+    std::uint64_t nextSequence = 1;
+
+    std::uint32_t acquire();          ///< 取一个空闲结点
+    void link(std::uint32_t index);   ///< 按到期回合放入对应的槽
+    void unlink(std::uint32_t index); ///< 从所在链表摘除（未在链表中时无操作）
+    void release(std::uint32_t index);
+    void cascade(int level);          ///< 将某层当前槽的定时器重新分配到下层
+};
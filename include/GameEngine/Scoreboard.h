@@ -0,0 +1,94 @@
+// include/GameEngine/Scoreboard.h
+#pragma once
+#include "GameObject.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @class Scoreboard
+ * @brief 实体计分项存储，每个计分项为一列按实体ID索引的整数
+ *
+ * 存储方式：
+ * - 每个计分项是一段连续的int数组（列式存储），下标为实体ID
+ * - 未写入过的实体取计分项的默认值
+ * - 批量运算在整列上一次完成，便于编译器向量化
+ *
+ * 与全局变量（GameEngine::variables）相互独立。
+ */
+class Scoreboard {
+public:
+    /// 实体ID（首次写入计分项时分配，见track；0表示未分配，读取时取默认值）
+    using EntityId = std::uint32_t;
+
+    /**
+     * @struct Objective
+     * @brief 单个计分项（一列数据）
+     */
+    struct Objective {
+        int defaultValue = 0;    ///< 未设置实体的取值
+        std::vector<int> values; ///< 按实体ID索引的数值列
+    };
+
+    /**
+     * @brief 创建计分项（已存在时重置）
+     * @param name 计分项名称
+     * @param defaultValue 默认值
+     */
+    void addObjective(const std::string& name, int defaultValue = 0);
+
+    /**
+     * @brief 检查计分项是否存在
+     * @param name 计分项名称
+     */
+    bool hasObjective(const std::string& name) const { return objectives.count(name) > 0; }
+
+    /**
+     * @brief 读取实体的计分值
+     * @param name 计分项名称
+     * @param id 实体ID
+     * @return 计分值（未设置或ID为0时为默认值）
+     * @throws runtime_error 计分项不存在时抛出异常
+     */
+    int get(const std::string& name, EntityId id) const;
+
+    /**
+     * @brief 为实体分配计分用的ID（已有ID时直接返回）
+     * @param entity 地图上的实体
+     * @return 实体ID
+     *
+     * 复用已释放的ID时，各计分项中该ID的旧值重置为默认值
+     */
+    EntityId track(GameObject& entity);
+
+    /**
+     * @brief 对一组实体执行同一运算
+     * @param name 计分项名称
+     * @param op 运算符（= += -= *= /=）
+     * @param ids 实体ID列表（须已通过track分配）
+     * @param value 右操作数
+     * @throws runtime_error 计分项不存在、运算符未知或除数为零时抛出异常
+     *
+     * 运算符在循环外分派，循环体只做单一的整数运算
+     */
+    void apply(const std::string& name, const std::string& op, const std::vector<EntityId>& ids, int value);
+
+    /**
+     * @brief 获取所有计分项（只读）
+     */
+    const std::map<std::string, Objective>& getObjectives() const { return objectives; }
+
+    /**
+     * @brief 清空所有计分项
+     */
+    void clear() { objectives.clear(); }
+
+private:
+    std::map<std::string, Objective> objectives; ///< 计分项名称 -> 数值列
+
+    Objective& require(const std::string& name);
+
+    friend class WorldSnapshot; ///< 允许快照直接读写数值列
+    friend class UndoJournal;   ///< 允许撤销日志恢复数值列
+};
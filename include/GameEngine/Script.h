@@ -0,0 +1,91 @@
+// include/GameEngine/Script.h
+#pragma once
+#include "CompiledCommand.h"
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @struct ScriptBlock
+ * @brief 脚本顶层块的编译结果
+ *
+ * 块类型：
+ * - INIT: init { ... }，块内所有命令依次执行
+ * - IF: if 条件 { ... }，条件成立时执行第一层命令
+ * - ITEM_EFFECT: item 使用效果 物品名: { ... }，物品使用时执行
+ */
+struct ScriptBlock {
+    enum class Kind {
+        INIT,        ///< 初始化块
+        IF,          ///< 条件块
+        ITEM_EFFECT  ///< 物品使用效果块
+    };
+
+    Kind kind = Kind::INIT;
+    std::string header;             ///< IF为条件表达式，ITEM_EFFECT为物品名
+    int line = 0;                   ///< 块声明所在行号
+    std::vector<std::string> lines; ///< 需要执行的命令源码（已去除注释和首尾空白）
+    CommandProgram commands;        ///< 与lines一一对应的预解析命令
+};
+
+/**
+ * @class ScriptError
+ * @brief 脚本结构错误，携带出错行号
+ *
+ * what()为 "第N行: 描述"，校验模式使用getLine()/getDetail()单独输出
+ */
+class ScriptError : public std::runtime_error {
+public:
+    ScriptError(int line, const std::string& detail)
+        : std::runtime_error("第" + std::to_string(line) + "行: " + detail), line(line), detail(detail) {}
+
+    int getLine() const { return line; }
+    const std::string& getDetail() const { return detail; }
+
+private:
+    int line;
+    std::string detail;
+};
+
+/**
+ * @class Script
+ * @brief 游戏脚本的编译结果
+ *
+ * 加载时将game.txt整体编译一次：划分顶层块、去除注释、
+ * 分词并预先解析命令处理器，执行阶段不再处理文本。
+ *
+ * 编译流程：
+ * 1. 单线程扫描一遍源文本，只定位顶层块的边界（不复制内容），同时收集宏定义
+ * 2. 各块相互独立，脚本较大时分配到多个线程并行展开for循环、宏调用并分词
+ * 3. 结果按源文件顺序保存，执行顺序与逐行读取时一致
+ *
+ * 宏与循环只在编译期展开，ScriptBlock中保存的是展开后的命令，
+ * 执行阶段与直接写出每条命令完全相同。
+ */
+class Script {
+public:
+    /**
+     * @brief 内存映射并编译脚本文件
+     * @param filename 脚本文件路径
+     * @return 编译结果
+     * @throws runtime_error 文件无法打开或脚本格式错误时抛出异常
+     */
+    static Script load(const std::string& filename);
+
+    /**
+     * @brief 编译脚本源文本
+     * @param source 脚本内容
+     * @return 编译结果
+     * @throws ScriptError 顶层出现块外命令、块未闭合、块声明格式错误或宏/循环展开失败时抛出异常
+     */
+    static Script compile(std::string_view source);
+
+    /**
+     * @brief 获取所有顶层块（按源文件顺序）
+     */
+    const std::vector<ScriptBlock>& getBlocks() const { return blocks; }
+
+private:
+    std::vector<ScriptBlock> blocks;
+};
@@ -0,0 +1,64 @@
+// include/GameEngine/ScriptLexer.h
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @struct ScriptToken
+ * @brief 词法单元，引用源文本中的一段（不复制）
+ */
+struct ScriptToken {
+    std::string_view raw; ///< 源文本中的原始片段（含引号和转义符）
+    bool plain = true;    ///< 不含引号和转义符时为true，可直接使用raw
+
+    /**
+     * @brief 获取去除引号并处理转义后的值
+     * @return 词法单元的实际内容
+     */
+    std::string value() const;
+};
+
+/**
+ * @class ScriptLexer
+ * @brief 脚本与命令共用的词法分析器
+ *
+ * 规则：
+ * - 空白分隔词法单元
+ * - 双引号内的空白不分隔，引号可出现在单元中间，如 effect="heal 50"
+ * - 反斜杠转义：\" \\ \n \t，其余字符原样保留
+ * - 引号外的 // 开始注释，直到行尾
+ * - 未闭合的引号延续到源文本结尾
+ *
+ * 分析过程单遍完成，只产生指向源文本的视图，不分配内存；
+ * 需要保存结果时再调用ScriptToken::value()。
+ */
+class ScriptLexer {
+public:
+    explicit ScriptLexer(std::string_view source) : source(source) {}
+
+    /**
+     * @brief 读取下一个词法单元
+     * @param token 输出的词法单元
+     * @return 是否读到词法单元（到达结尾时返回false）
+     */
+    bool next(ScriptToken& token);
+
+    /**
+     * @brief 去除行中引号外的 // 注释
+     * @param line 单行文本
+     * @return 注释前的部分
+     */
+    static std::string_view stripComment(std::string_view line);
+
+    /**
+     * @brief 分词并保存结果
+     * @param line 输入文本
+     * @return 处理引号和转义后的词法单元
+     */
+    static std::vector<std::string> split(std::string_view line);
+
+private:
+    std::string_view source;
+    std::size_t pos = 0;
+};
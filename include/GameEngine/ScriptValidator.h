@@ -0,0 +1,61 @@
+// include/GameEngine/ScriptValidator.h
+#pragma once
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @struct Diagnostic
+ * @brief 脚本校验发现的一条问题
+ */
+struct Diagnostic {
+    enum class Severity {
+        ERROR,   ///< 执行时必然失败或产生错误数据
+        WARNING  ///< 可以执行，但很可能是笔误
+    };
+
+    Severity severity = Severity::ERROR;
+    int line = 0;        ///< 源文件行号
+    std::string message; ///< 问题描述
+};
+
+/**
+ * @class ScriptValidator
+ * @brief 无界面的脚本静态检查（--validate模式）
+ *
+ * 只编译脚本、不执行命令，也不初始化终端。检查内容：
+ * - 块结构：块外命令、块未闭合、物品效果块声明格式
+ * - 未知命令与子命令、参数个数不足
+ * - 引用未定义的物品、NPC、地图
+ * - 坐标格式错误或超出地图范围
+ *
+ * 物品、NPC、地图的定义先在整个脚本中收集一遍，
+ * 因此引用出现在定义之前不算错误。
+ */
+class ScriptValidator {
+public:
+    /**
+     * @brief 检查脚本源文本
+     * @param source 脚本内容
+     * @return 按行号排序的问题列表
+     */
+    static std::vector<Diagnostic> validate(std::string_view source);
+
+    /**
+     * @brief 检查脚本文件
+     * @param filename 脚本文件路径
+     * @return 问题列表（文件无法打开时返回一条第0行的错误）
+     */
+    static std::vector<Diagnostic> validateFile(const std::string& filename);
+
+    /**
+     * @brief 在线程池中并行检查多个文件并输出结果
+     * @param files 脚本文件列表
+     * @param out 输出流，格式为 "文件:行号: 错误: 描述"
+     * @return 错误总数（不含警告）
+     *
+     * 各文件独立检查，输出按参数顺序排列，与线程调度无关
+     */
+    static int run(const std::vector<std::string>& files, std::ostream& out);
+};
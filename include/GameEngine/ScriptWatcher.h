@@ -0,0 +1,36 @@
+// include/GameEngine/ScriptWatcher.h
+#pragma once
+#include <filesystem>
+#include <string>
+
+/**
+ * @class ScriptWatcher
+ * @brief 监视脚本文件的修改（用于热重载）
+ *
+ * Linux下使用inotify监视脚本所在目录，可以识别编辑器"写临时文件再重命名"的保存方式；
+ * 其他平台退化为比较文件修改时间。poll()不阻塞，适合在游戏循环中调用。
+ */
+class ScriptWatcher {
+public:
+    /**
+     * @brief 开始监视文件
+     * @param filename 脚本文件路径
+     * @throws runtime_error 无法建立监视时抛出异常
+     */
+    explicit ScriptWatcher(const std::string& filename);
+    ~ScriptWatcher();
+
+    ScriptWatcher(const ScriptWatcher&) = delete;
+    ScriptWatcher& operator=(const ScriptWatcher&) = delete;
+
+    /**
+     * @brief 检查文件是否被修改
+     * @return 自上次调用以来文件被写入或替换时返回true（多次修改合并为一次）
+     */
+    bool poll();
+
+private:
+    std::filesystem::path path;               ///< 脚本路径
+    int fd = -1;                              ///< inotify描述符（未使用inotify时为-1）
+    std::filesystem::file_time_type lastWrite; ///< 上次检查时的修改时间（退化模式）
+};
@@ -0,0 +1,175 @@
+// include/GameEngine/UndoJournal.h
+#pragma once
+#include "CompiledCommand.h"
+#include "GameMap.h"
+#include "GameObject.h"
+#include "PendingMap.h"
+#include "Scheduler.h"
+#include "Scoreboard.h"
+#include <list>
+#include <optional>
+#include <set>
+#include <string>
+#include <variant>
+#include <vector>
+
+class GameEngine;
+
+/**
+ * @class UndoJournal
+ * @brief 脚本块事务的撤销日志
+ *
+ * 每条命令执行前，按命令参数记录它将修改的状态的原值（只记录被触及的键）：
+ * - /map setblock|fill：目标区域内原有的对象；create：整张地图
+ * - 尚未构建的地图：原有的构建命令
+ * - /item、/npc：对应名称的定义；/scoreboard：变量或整列计分项
+ * - /item give：物品栏；/teleport：玩家位置
+ * - /entity set：被修改的NPC、物品或地图对象
+ * - /schedule add|cancel：同名的定时器
+ * - 实体ID分配状态：在事务开始时记录（计分时新分配的ID在回滚时收回）
+ *
+ * 回滚时逆序恢复，开销与事务内修改的数据量成正比，与世界大小无关。
+ * 对话框等界面状态不在日志范围内。
+ */
+class UndoJournal {
+public:
+    explicit UndoJournal(GameEngine& engine) : engine(engine), entityIds(GameMap::entityIdState()) {}
+
+    UndoJournal(const UndoJournal&) = delete;
+    UndoJournal& operator=(const UndoJournal&) = delete;
+
+    /**
+     * @brief 命令执行前记录其将修改的状态
+     * @param command 即将执行的命令（选择器已展开时为展开后的命令）
+     */
+    void record(const CompiledCommand& command);
+
+    /**
+     * @brief 记录地图区域的原有对象（地图必须已构建）
+     * @param mapName 地图名称
+     * @param x1,y1,x2,y2 区域两角坐标
+     */
+    void recordArea(const std::string& mapName, int x1, int y1, int x2, int y2);
+
+    /**
+     * @brief 记录物品定义及其使用效果
+     * @param name 物品名称
+     */
+    void recordItem(const std::string& name);
+
+    /**
+     * @brief 记录按名称查找到的地图实体
+     * @param name 实体名称
+     *
+     * 实体在已构建的地图上时记录其所在格；否则记录放置了它的待构建地图的构建命令
+     */
+    void recordMapEntity(const std::string& name);
+
+    /**
+     * @brief 记录全局变量的原值
+     * @param name 变量名
+     */
+    void recordVariable(const std::string& name);
+
+    /**
+     * @brief 记录整列计分项
+     * @param name 计分项名称
+     */
+    void recordObjective(const std::string& name);
+
+    /**
+     * @brief 记录玩家所在地图、位置和朝向
+     */
+    void recordPlayer();
+
+    /**
+     * @brief 标记事务中有命令失败
+     */
+    void markFailed() { failed = true; }
+
+    /**
+     * @brief 事务中是否有命令失败
+     */
+    bool hasFailed() const { return failed; }
+
+    /**
+     * @brief 逆序撤销所有记录的修改并清空日志
+     */
+    void rollback();
+
+private:
+    struct AreaEntry {
+        std::string map;
+        int x1, y1, x2, y2;
+        std::vector<GameObject> before;
+    };
+    struct MapEntry {
+        std::string map;
+        std::optional<GameMap> before; ///< 不存在时为空
+    };
+    struct PendingEntry {
+        std::string map;
+        std::optional<PendingMapProgram> before; ///< 原构建命令（原先不是待构建地图时为空）
+        bool built;                           ///< 记录时地图是否已存在
+    };
+    struct ItemEntry {
+        std::string name;
+        std::optional<GameObject> before;
+        std::optional<CommandProgram> effects;
+    };
+    struct NpcEntry {
+        std::string name;
+        std::optional<GameObject> before;
+    };
+    struct VariableEntry {
+        std::string name;
+        std::optional<int> before;
+    };
+    struct ObjectiveEntry {
+        std::string name;
+        std::optional<Scoreboard::Objective> before;
+    };
+    struct InventoryEntry {
+        std::list<GameObject> items;
+        int instanceCounter;
+        int engineCounter;
+    };
+    struct PlayerEntry {
+        std::string map;
+        int x, y;
+        char dir;
+    };
+    struct TimerEntry {
+        std::string name;
+        std::optional<Scheduler::Timer> before; ///< 不存在时为空
+    };
+
+    using Entry = std::variant<AreaEntry, MapEntry, PendingEntry, ItemEntry, NpcEntry,
+                               VariableEntry, ObjectiveEntry, InventoryEntry, PlayerEntry, TimerEntry>;
+
+    GameEngine& engine;
+    GameMap::EntityIdState entityIds; ///< 事务开始时的实体ID分配状态
+    std::vector<Entry> entries;
+    std::set<std::string> recorded; ///< 已记录原值的键（同一键只需最早的原值）
+    bool failed = false;
+
+    bool firstRecord(const std::string& key) { return recorded.insert(key).second; }
+
+    void recordMap(const std::string& name);
+    void recordPending(const std::string& name);
+    void recordPlacement(const std::vector<std::string>& args);
+    void recordNpc(const std::string& name);
+    void recordEntity(const std::string& name);
+    void restoreEntityIds();
+
+    void undo(AreaEntry& entry);
+    void undo(MapEntry& entry);
+    void undo(PendingEntry& entry);
+    void undo(ItemEntry& entry);
+    void undo(NpcEntry& entry);
+    void undo(VariableEntry& entry);
+    void undo(ObjectiveEntry& entry);
+    void undo(InventoryEntry& entry);
+    void undo(PlayerEntry& entry);
+    void undo(TimerEntry& entry);
+};
@@ -0,0 +1,62 @@
+// include/GameEngine/WorldSnapshot.h
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class GameEngine;
+
+/**
+ * @class WorldSnapshot
+ * @brief 脚本加载结果的二进制快照缓存
+ *
+ * 使用流程：
+ * 1. 加载脚本时计算内容哈希
+ * 2. 快照存在且哈希一致时直接从快照恢复世界，跳过命令执行
+ * 3. 否则执行脚本，成功后写入新快照
+ *
+ * 快照内容：地图及其对象（含实体ID）、实体ID分配状态、尚未构建地图的构建命令（含记录时的物品定义）、NPC模板、
+ * 物品定义、变量、地点标记、计分项、物品栏、玩家位置、定时器。
+ *
+ * 格式：8字节魔数 + 版本号 + 脚本哈希，其后为长度前缀的紧凑二进制记录，
+ * 数值按本机字节序存储。快照只用于缓存，损坏或版本不符时自动忽略。
+ * 修改快照内容或引擎初始化语义时需要递增 VERSION。
+ */
+class WorldSnapshot {
+public:
+    static constexpr std::uint32_t VERSION = 6; ///< 快照格式版本
+
+    /**
+     * @brief 计算脚本内容哈希（FNV-1a 64位，包含快照版本）
+     * @param content 脚本内容
+     * @param strict 是否为严格加载模式（两种模式的加载结果可能不同）
+     * @return 哈希值
+     */
+    static std::uint64_t hash(std::string_view content, bool strict = false);
+
+    /**
+     * @brief 获取脚本对应的快照路径
+     * @param scriptFile 脚本文件路径
+     * @return 快照文件路径（脚本路径 + ".snap"）
+     */
+    static std::string pathFor(const std::string& scriptFile) { return scriptFile + ".snap"; }
+
+    /**
+     * @brief 尝试从快照恢复世界
+     * @param engine 游戏引擎引用（应为刚构造的状态）
+     * @param filename 快照文件路径
+     * @param scriptHash 当前脚本哈希
+     * @return 是否恢复成功（文件不存在、哈希不符或损坏时返回false，引擎状态保持为空）
+     */
+    static bool load(GameEngine& engine, const std::string& filename, std::uint64_t scriptHash);
+
+    /**
+     * @brief 写入快照
+     * @param engine 游戏引擎引用（只读）
+     * @param filename 快照文件路径
+     * @param scriptHash 脚本哈希
+     *
+     * 先写入临时文件再重命名，写入失败时记录到error.log，不影响游戏运行
+     */
+    static void save(const GameEngine& engine, const std::string& filename, std::uint64_t scriptHash);
+};
@@ -0,0 +1,107 @@
+// src/Commands/CommandAccess.cpp
+#include "CommandAccess.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+constexpr int RESOURCE_COUNT = 6;
+
+// 参数中是否引用实体计分项（{实体名.计分项}）：求值时按名称查找地图上的实体
+bool referencesEntityScore(const std::vector<std::string>& args) {
+    for (const auto& arg : args) {
+        for (std::size_t open = arg.find('{'); open != std::string::npos; open = arg.find('{', open + 1)) {
+            const std::size_t close = arg.find('}', open);
+            if (close == std::string::npos) break;
+            if (arg.find('.', open) < close) return true;
+        }
+    }
+    return false;
+}
+
+// 最近一次读、写所在的批次（-1表示尚未访问）
+struct LastAccess {
+    int read = -1;
+    int write = -1;
+};
+
+} // namespace
+
+CommandAccess CommandAccess::analyze(const CompiledCommand& command) {
+    CommandAccess access;
+    const auto& args = command.args;
+    if (args.empty()) return access;
+    if (!command.handler || command.hasSelector) {
+        access.barrier = true;
+        return access;
+    }
+
+    const std::string& cmd = args[0];
+    const std::string sub = args.size() > 1 ? args[1] : std::string();
+    if (cmd == "/map" && args.size() >= 3 && (sub == "create" || sub == "setblock" || sub == "fill")) {
+        access.map = args[2];
+        if (sub != "create") access.reads = ITEMS; // 放置item类型时读取物品定义
+    } else if (cmd == "/item" && (sub == "define" || sub == "setproperty")) {
+        access.writes = ITEMS;
+    } else if (cmd == "/item" && sub == "give") {
+        access.reads = ITEMS;
+        access.writes = INVENTORY;
+    } else if (cmd == "/npc" && (sub == "create" || sub == "setdialogue")) {
+        access.reads = NPCS; // 模板与存在性检查
+        access.writes = NPCS;
+    } else if (cmd == "/scoreboard" && referencesEntityScore(args)) {
+        access.barrier = true; // 读取任意地图上的实体，与地图写入冲突
+    } else if (cmd == "/scoreboard" && sub == "objectives") {
+        access.writes = SCOREBOARD;
+    } else if (cmd == "/scoreboard" && (sub == "add" || sub == "set" || sub == "operation")) {
+        access.reads = VARIABLES; // 表达式可引用其他变量
+        access.writes = VARIABLES;
+    } else if (cmd == "/trigger") {
+        access.reads = NPCS;
+        access.writes = DIALOG;
+    } else {
+        access.barrier = true;
+    }
+    return access;
+}
+
+std::vector<std::vector<std::size_t>> CommandAccess::planWaves(const std::vector<CommandAccess>& accesses) {
+    LastAccess resources[RESOURCE_COUNT];
+    std::unordered_map<std::string, int> lastMapWrite; // 地图只有写入
+    int lastBarrier = -1;
+    int lastWave = -1;
+
+    std::vector<std::vector<std::size_t>> waves;
+    for (std::size_t i = 0; i < accesses.size(); ++i) {
+        const CommandAccess& access = accesses[i];
+
+        int wave = lastBarrier + 1;
+        if (access.barrier) {
+            wave = lastWave + 1;
+        } else {
+            for (int r = 0; r < RESOURCE_COUNT; ++r) {
+                const std::uint32_t bit = 1u << r;
+                if (access.reads & bit) wave = std::max(wave, resources[r].write + 1);
+                if (access.writes & bit) wave = std::max({wave, resources[r].write + 1, resources[r].read + 1});
+            }
+            if (!access.map.empty()) {
+                auto it = lastMapWrite.find(access.map);
+                if (it != lastMapWrite.end()) wave = std::max(wave, it->second + 1);
+            }
+        }
+
+        // 更新各资源最近访问的批次
+        if (access.barrier) lastBarrier = wave;
+        for (int r = 0; r < RESOURCE_COUNT; ++r) {
+            const std::uint32_t bit = 1u << r;
+            if (access.reads & bit) resources[r].read = std::max(resources[r].read, wave);
+            if (access.writes & bit) resources[r].write = wave;
+        }
+        if (!access.map.empty()) lastMapWrite[access.map] = wave;
+        lastWave = std::max(lastWave, wave);
+
+        if (waves.size() <= static_cast<std::size_t>(wave)) waves.resize(wave + 1);
+        waves[wave].push_back(i);
+    }
+    return waves;
+}
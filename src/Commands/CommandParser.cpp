@@ -8,9 +8,14 @@
 #include "ConcreteCommands/TeleportCommand.h"
 #include "ConcreteCommands/TriggerCommand.h"
 #include "ConcreteCommands/ScoreboardCommand.h"
+#include "ConcreteCommands/ScheduleCommand.h"
+#include "EntitySelector.h"
+#include "LoadProfiler.h"
+#include "ScriptLexer.h"
+#include <unordered_set>
+#include <utility>
 #include <vector>
 #include <string>
-#include <sstream>
 
 // 构造函数中的命令注册
 CommandParser::CommandParser() : log("error.log") {
@@ -21,6 +26,21 @@ CommandParser::CommandParser() : log("error.log") {
     registerCommand("/teleport", std::make_unique<TeleportCommand>());
     registerCommand("/trigger", std::make_unique<TriggerCommand>());
     registerCommand("/scoreboard", std::make_unique<ScoreboardCommand>());
+    registerCommand("/schedule", std::make_unique<ScheduleCommand>());
+}
+
+bool CommandParser::addCommand(const std::string& cmd, std::unique_ptr<CommandHandler> handler) {
+    CommandParser& parser = getInstance();
+    if (!parser.commands.emplace(cmd, std::move(handler)).second) return false;
+    parser.commandNames.insert(cmd);
+    parser.compiledCache.clear(); // 之前可能已编译为未知命令
+    return true;
+}
+
+const CommandHandler* CommandParser::findCommand(const std::string& cmd) {
+    CommandParser& parser = getInstance();
+    auto it = parser.commands.find(cmd);
+    return it != parser.commands.end() ? it->second.get() : nullptr;
 }
 
 // 命令执行逻辑
@@ -28,25 +48,159 @@ void CommandParser::parseAndExecute(const std::string& commandLine, GameEngine&
     getInstance().executeCommandImpl(commandLine, engine);
 }
 
-void CommandParser::executeCommandImpl(const std::string& commandLine, GameEngine& engine) {
-    // 1. 解析命令为tokens（保持原逻辑）
+CompiledCommand CommandParser::compile(const std::string& commandLine, int line) {
+    // 编译结果会被缓存、延迟或定时执行，比源文本活得久，参数必须自己持有：
+    // 每个词在这里物化一次，随后移动进CompiledCommand::args，不再拷贝
     std::vector<std::string> tokens;
-    std::stringstream ss(commandLine);
-    std::string token;
-    while (ss >> token) {
-        tokens.push_back(token);
+    ScriptLexer lexer(commandLine);
+    ScriptToken token;
+    while (lexer.next(token)) {
+        tokens.push_back(token.value());
+    }
+    return compile(std::move(tokens), line);
+}
+
+CompiledCommand CommandParser::compile(std::vector<std::string> tokens, int line) {
+    CompiledCommand command;
+    command.line = line;
+    command.args = std::move(tokens);
+    if (command.args.empty()) return command;
+
+    // 预先查找处理器、子命令并标记选择器参数
+    CommandParser& parser = getInstance();
+    auto it = parser.commands.find(command.args[0]);
+    if (it != parser.commands.end()) {
+        command.handler = it->second.get();
+        command.subcommand = command.handler->getSubcommands().find(command.args);
+    }
+    for (size_t i = 1; i < command.args.size(); ++i) {
+        if (EntitySelector::isSelector(command.args[i])) {
+            command.hasSelector = true;
+            break;
+        }
+    }
+    return command;
+}
+
+void CommandParser::execute(const CompiledCommand& command, GameEngine& engine) {
+    getInstance().executeCompiled(command, engine);
+}
+
+void CommandParser::executeCommandImpl(const std::string& commandLine, GameEngine& engine) {
+    // 1. 查找编译缓存，未命中时编译一次（缓存已满则不再缓存新命令）
+    auto it = compiledCache.find(commandLine);
+    if (it == compiledCache.end()) {
+        if (compiledCache.size() >= MAX_CACHED_COMMANDS) {
+            executeCompiled(compile(commandLine), engine);
+            return;
+        }
+        it = compiledCache.emplace(commandLine, compile(commandLine)).first;
+    }
+
+    // 2. 执行命令处理器
+    executeCompiled(it->second, engine);
+}
+
+void CommandParser::executeCompiled(const CompiledCommand& command, GameEngine& engine) {
+    if (command.args.empty()) return;
+    LoadProfiler::CommandScope profile(command); // 分析模式下统计本条命令的开销
+    UndoJournal* journal = engine.getJournal();
+    if (!command.handler) {
+        if (journal) journal->markFailed();
+        report("未知命令: " + command.args[0]);
+        return;
     }
-    if (tokens.empty()) return;
 
-    // 2. 查找并执行命令处理器
+    CommandStatus status;
     try {
-        auto it = commands.find(tokens[0]);
-        if (it != commands.end()) {
-            it->second->handle(tokens, engine); // 多态调用
+        // 处理器不支持选择器时，展开为每个命中实体的名称分别执行
+        if (command.hasSelector && !command.handler->acceptsSelectors()) {
+            for (size_t i = 1; i < command.args.size(); ++i) {
+                if (EntitySelector::isSelector(command.args[i])) {
+                    expandSelector(command, i, engine);
+                    return;
+                }
+            }
+        }
+        // 事务中先记录将被修改的状态
+        if (journal) journal->record(command);
+        if (command.subcommand) {
+            status = command.subcommand->invoke(command.args, engine);
         } else {
-            log.error("未知命令: " + tokens[0]);
+            status = command.handler->handle(command.args, engine); // 报告用法或未知子命令
         }
     } catch (const std::exception& e) {
-        log.error(std::string("命令执行失败: ") + e.what());
+        // 处理函数以返回值报告失败，这里只兜底意外的异常（如选择器格式错误）
+        status = CommandStatus::failure(e.what());
+    }
+    if (!status) {
+        if (journal) journal->markFailed();
+        report("命令执行失败: " + status.message);
+    }
+}
+
+void CommandParser::report(std::string message) {
+    CommandParser& parser = getInstance();
+    bool full = false;
+    {
+        std::lock_guard<std::mutex> lock(parser.diagnosticsMutex);
+        if (parser.capture) {
+            parser.capture->push_back(message);
+            if (parser.divertCapture) return;
+        }
+        parser.diagnostics.push_back(std::move(message));
+        full = parser.diagnostics.size() >= MAX_BUFFERED_DIAGNOSTICS;
+    }
+    if (full) parser.flushBuffered();
+}
+
+CommandParser::DiagnosticsCapture::DiagnosticsCapture(std::vector<std::string>& messages, bool divert) {
+    CommandParser& parser = getInstance();
+    std::lock_guard<std::mutex> lock(parser.diagnosticsMutex);
+    previous = std::exchange(parser.capture, &messages);
+    previousDivert = std::exchange(parser.divertCapture, divert);
+}
+
+CommandParser::DiagnosticsCapture::~DiagnosticsCapture() {
+    CommandParser& parser = getInstance();
+    std::lock_guard<std::mutex> lock(parser.diagnosticsMutex);
+    parser.capture = previous;
+    parser.divertCapture = previousDivert;
+}
+
+void CommandParser::flushBuffered() {
+    std::vector<std::string> pending;
+    {
+        std::lock_guard<std::mutex> lock(diagnosticsMutex);
+        pending.swap(diagnostics);
+    }
+    if (pending.empty()) return;
+
+    // 合并为一次写入（每行带[error]前缀）
+    std::string text = std::move(pending[0]);
+    for (size_t i = 1; i < pending.size(); ++i) {
+        text += "\n[error] ";
+        text += pending[i];
     }
-}
\ No newline at end of file
+    log.error(text);
+}
+
+void CommandParser::expandSelector(const CompiledCommand& command, size_t index, GameEngine& engine) {
+    // 先收集名称再执行，避免命令修改地图导致遍历失效
+    std::vector<std::string> names;
+    std::unordered_set<std::string> seen;
+    for (const SelectedEntity& entity : EntitySelector::parse(command.args[index]).select(engine)) {
+        const std::string& name = entity.object.name;
+        if (!name.empty() && seen.insert(name).second) names.push_back(name);
+    }
+
+    CompiledCommand expanded = command;
+    expanded.hasSelector = false;
+    for (size_t i = index + 1; i < expanded.args.size(); ++i) {
+        if (EntitySelector::isSelector(expanded.args[i])) expanded.hasSelector = true;
+    }
+    for (const auto& name : names) {
+        expanded.args[index] = name;
+        executeCompiled(expanded, engine);
+    }
+}
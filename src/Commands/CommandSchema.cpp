@@ -0,0 +1,161 @@
+// src/Commands/CommandSchema.cpp
+#include "CommandSchema.h"
+#include "EntitySelector.h"
+#include <charconv>
+
+namespace CommandSchema {
+
+const std::string Cursor::EMPTY;
+
+namespace {
+
+// 连接剩余参数（至少一个）
+std::string joinRest(Cursor& cursor, const char* separator) {
+    if (!cursor.need()) return {};
+    const auto& args = cursor.args;
+    std::string text = args[cursor.index];
+    for (++cursor.index; cursor.index < args.size(); ++cursor.index) {
+        text += separator;
+        text += args[cursor.index];
+    }
+    return text;
+}
+
+} // namespace
+
+Word::Value Word::parse(Cursor& cursor, const char*) {
+    if (!cursor.need()) return Cursor::EMPTY;
+    return cursor.args[cursor.index++];
+}
+
+Coord::Value Coord::parse(Cursor& cursor, const char*) {
+    if (!cursor.need()) return {};
+    const bool combined = cursor.args[cursor.index].find(',') != std::string::npos;
+    if (!combined && !cursor.need(2)) return {};
+    auto value = CommandUtils::parseCoordinates(cursor.args, cursor.index);
+    if (!value) {
+        cursor.fail("坐标格式错误: Invalid coordinates format");
+        return {};
+    }
+    cursor.index += combined ? 1 : 2;
+    return *value;
+}
+
+Count::Value Count::parse(Cursor& cursor, const char* name) {
+    if (!cursor.need()) return 0;
+    const std::string& text = cursor.args[cursor.index++];
+    auto value = convert(text);
+    if (!value) {
+        cursor.fail(std::string(name) + "必须是正整数: " + text);
+        return 0;
+    }
+    return *value;
+}
+
+std::optional<int> Count::convert(std::string_view text) {
+    int value = 0;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || ptr != text.data() + text.size() || value <= 0) return std::nullopt;
+    return value;
+}
+
+Tokens::Value Tokens::parse(Cursor& cursor, const char*) {
+    if (!cursor.need()) return {};
+    const auto& args = cursor.args;
+    Value tokens(args.begin() + static_cast<std::ptrdiff_t>(cursor.index), args.end());
+    cursor.index = args.size();
+    return tokens;
+}
+
+Setting::Value Setting::parse(Cursor& cursor, const char* name) {
+    const std::string_view key(name, std::string_view(name).find('=') + 1); // 含'='
+    if (cursor.failed() || cursor.index >= cursor.args.size()) return std::nullopt;
+    const std::string& arg = cursor.args[cursor.index];
+    if (arg.compare(0, key.size(), key) != 0) return std::nullopt;
+    ++cursor.index;
+    return arg.substr(key.size());
+}
+
+Text::Value Text::parse(Cursor& cursor, const char*) {
+    return joinRest(cursor, " ");
+}
+
+Lines::Value Lines::parse(Cursor& cursor, const char*) {
+    return joinRest(cursor, "\n");
+}
+
+Options::Value Options::parse(Cursor& cursor, const char*) {
+    if (cursor.failed()) return {};
+    Value params = CommandUtils::parseNamedParams(cursor.args, cursor.index);
+    cursor.index = cursor.args.size();
+    return params;
+}
+
+Assignments::Value Assignments::parse(Cursor& cursor, const char* name) {
+    if (!cursor.need()) return {};
+    return Options::parse(cursor, name);
+}
+
+Keyword::Value Keyword::parse(Cursor& cursor, const char* name) {
+    if (!cursor.need()) return Cursor::EMPTY;
+    const auto& args = cursor.args;
+    if (args[cursor.index] != name) {
+        cursor.fail("未知子命令: " + args[cursor.index - 1] + " " + args[cursor.index]);
+        return Cursor::EMPTY;
+    }
+    return args[cursor.index++];
+}
+
+std::string formatUsage(const char* name, bool optional, bool keyword) {
+    if (keyword) return name;
+    const char open = optional ? '[' : '<';
+    const char close = optional ? ']' : '>';
+    std::string usage;
+    std::string_view rest = name;
+    while (!rest.empty()) {
+        const std::size_t space = rest.find(' ');
+        if (!usage.empty()) usage += ' ';
+        usage += open;
+        usage += rest.substr(0, space);
+        usage += close;
+        rest = space == std::string_view::npos ? std::string_view() : rest.substr(space + 1);
+    }
+    return usage;
+}
+
+const Subcommand* CommandTable::find(const std::vector<std::string>& args) const {
+    const std::size_t first = hasSubcommands ? 2 : 1; // 第一个参数的下标
+    auto it = index.end();
+    if (!hasSubcommands) it = index.find(std::string());
+    else if (args.size() >= 2) it = index.find(args[1]);
+    if (it == index.end()) return nullptr;
+
+    const Overloads& overloads = it->second;
+    if (overloads.selector && args.size() > first && EntitySelector::isSelector(args[first])) {
+        return overloads.selector;
+    }
+    return overloads.plain ? overloads.plain : overloads.selector;
+}
+
+CommandStatus CommandTable::dispatch(const std::vector<std::string>& args, GameEngine& engine) const {
+    if (const Subcommand* subcommand = find(args)) return subcommand->invoke(args, engine);
+    if (args.size() < 2) return CommandStatus::failure("用法: " + usage());
+    return CommandStatus::failure("未知子命令: " + args[1]);
+}
+
+std::string CommandTable::usage() const {
+    if (!hasSubcommands) return entries.empty() ? command : entries.front()->getUsage();
+    std::string names;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        // 选择器形式与普通形式同名，只列一次
+        const std::string& name = entries[i]->getName();
+        bool listed = false;
+        for (std::size_t j = 0; j < i; ++j) listed = listed || entries[j]->getName() == name;
+        if (listed) continue;
+        if (!names.empty()) names += '|';
+        names += name;
+    }
+    return command + " <" + names + ">";
+}
+
+} // namespace CommandSchema
@@ -1,42 +1,57 @@
 // src/Commands/CommandUtils.cpp
 #include "CommandUtils.h"
-#include <sstream>
+#include <cctype>
+#include <charconv>
 
 using namespace std;
 
-unordered_map<string, string> CommandUtils::parseNamedParams(const vector<string>& args, size_t start) {
-    unordered_map<string, string> params;
-    for (size_t i = start; i < args.size(); ++i) {
-        size_t eqPos = args[i].find('=');
-        if (eqPos != string::npos) {
-            string key = args[i].substr(0, eqPos);
-            string value = args[i].substr(eqPos + 1);
-            params[key] = value;
+optional<string_view> CommandUtils::ParamView::find(string_view key) const {
+    if (!args) return nullopt;
+    // 从后往前找，重复的键以最后一个为准
+    for (size_t i = args->size(); i > start; --i) {
+        string_view arg = (*args)[i - 1];
+        if (arg.size() > key.size() && arg[key.size()] == '=' && arg.compare(0, key.size(), key) == 0) {
+            return arg.substr(key.size() + 1);
         }
     }
-    return params;
+    return nullopt;
 }
 
-pair<int, int> CommandUtils::parseCoordinates(const vector<string>& args, size_t index) {
-    try {
-        // 尝试x,y格式
-        if (args[index].find(',') != string::npos) {
-            vector<string> parts;
-            stringstream ss(args[index]);
-            string part;
-            while (getline(ss, part, ',')) {
-                parts.push_back(part);
-            }
-            if (parts.size() >= 2) {
-                return {stoi(parts[0]), stoi(parts[1])};
-            }
-        }
-        // 尝试x y格式
-        if (index + 1 < args.size()) {
-            return {stoi(args[index]), stoi(args[index+1])};
-        }
-    } catch (...) {
-        throw runtime_error("Invalid coordinates format");
+CommandStatus CommandUtils::ParamView::getInt(string_view key, int& value) const {
+    auto text = find(key);
+    if (!text) return CommandStatus::success();
+    auto parsed = toInt(*text);
+    if (!parsed) return CommandStatus::failure("参数必须是整数: " + string(key) + "=" + string(*text));
+    value = *parsed;
+    return CommandStatus::success();
+}
+
+optional<pair<int, int>> CommandUtils::parseCoordinates(const vector<string>& args, size_t index) {
+    if (index >= args.size()) return nullopt;
+    optional<int> x, y;
+    // 尝试x,y格式
+    string_view arg = args[index];
+    size_t comma = arg.find(',');
+    if (comma != string_view::npos) {
+        size_t end = arg.find(',', comma + 1);
+        x = toInt(arg.substr(0, comma));
+        y = toInt(arg.substr(comma + 1, end - comma - 1));
+    }
+    // 尝试x y格式
+    else if (index + 1 < args.size()) {
+        x = toInt(arg);
+        y = toInt(args[index + 1]);
     }
-    throw runtime_error("Not enough coordinates provided");
-}
\ No newline at end of file
+    if (!x || !y) return nullopt;
+    return pair<int, int>{*x, *y};
+}
+
+optional<int> CommandUtils::toInt(string_view text) {
+    while (!text.empty() && isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+    if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+
+    int value = 0;
+    auto [ptr, ec] = from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != errc() || ptr == text.data()) return nullopt;
+    return value;
+}
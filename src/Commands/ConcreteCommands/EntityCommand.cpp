@@ -3,59 +3,52 @@
 #include "CommandUtils.h"
 #include "GameEngine.h"
 #include "GameMap.h"
+#include "EntitySelector.h"
 
-void EntityCommand::handle(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 3) {
-        throw std::runtime_error("Usage: /entity <set|get> <name> <property> [value]");
-    }
+using namespace CommandSchema;
 
-    const std::string& subcmd = args[1];
-    if (subcmd == "set") {
-        handleSet(args, engine);
-    } else {
-        throw std::runtime_error("未知子命令: " + subcmd);
-    }
+namespace {
+// 剩余参数合并为值
+const Parser<Word, Word, Text> SET{"/entity", "set", {"name|selector", "property", "value..."}};
 }
 
-void EntityCommand::handleSet(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 5) {
-        throw std::runtime_error("Usage: /entity set <name> <property> <value>");
-    }
+EntityCommand::EntityCommand() : CommandHandler("/entity") {
+    subcommands.add(SET, this, &EntityCommand::handleSet);
+}
 
-    const std::string& name = args[2];
-    const std::string& property = args[3];
-    
-    // 合并剩余参数作为值
-    std::string value;
-    for (size_t i = 4; i < args.size(); ++i) {
-        if (i > 4) value += " ";
-        value += args[i];
-    }
+CommandStatus EntityCommand::handleSet(GameEngine& engine, const std::vector<std::string>&,
+                                       const std::string& name, const std::string& property, std::string value) {
+    // display属性直接修改显示字形
+    auto apply = [&](GameObject& obj) {
+        if (property == "display") obj.setDisplay(value);
+        else obj.setProperty(property, value);
+    };
 
+    // 选择器：直接修改每个命中的地图实体
+    if (EntitySelector::isSelector(name)) {
+        for (const SelectedEntity& entity : EntitySelector::parse(name).select(engine)) {
+            apply(entity.object);
+        }
+    }
     // 在NPC中查找
-    if (engine.getNpcs().count(name)) {
-        engine.getNpcs()[name].setProperty(property, value);
+    else if (engine.getNpcs().count(name)) {
+        apply(engine.getNpcs()[name]);
     }
     // 在物品中查找
     else if (engine.getItems().count(name)) {
-        engine.getItems()[name].setProperty(property, value);
+        apply(engine.getItems()[name]);
     }
     // 在地图对象中查找
     else {
-        bool found = false;
-        for (auto& [mapName, gameMap] : engine.getMaps()) {
-            if (gameMap.hasObject(name)) {
-                gameMap.getObjectByName(name).setProperty(property, value);
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            throw std::runtime_error("未找到实体: " + name);
+        GameObject* obj = engine.findEntity(name);
+        if (!obj) {
+            return CommandStatus::failure("未找到实体: " + name);
         }
+        apply(*obj);
     }
 #ifdef DEBUG
     Log log("debug.log");
     log.error("已更新实体 ", name, " 的属性 ", property);
 #endif
+    return CommandStatus::success();
 }
\ No newline at end of file
@@ -6,46 +6,46 @@
 #include <sstream>
 #include <iostream>
 
-void ItemCommand::handle(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 2) throw std::runtime_error("Usage: /item <define|setproperty|...>");
-    
-    const std::string& subcmd = args[1];
-    if (subcmd == "define") handleDefine(args, engine);
-    else if (subcmd == "setproperty") handleSetProperty(args, engine);
-    else if (subcmd == "give") handleGive(args, engine);
-    else throw std::runtime_error("未知子命令: " + subcmd);
+using namespace CommandSchema;
+
+namespace {
+const Parser<Word, Options> DEFINE{"/item", "define", {"name", "properties..."}};
+const Parser<Word, Assignments> SET_PROPERTY{"/item", "setproperty", {"name", "key=value..."}};
+const Parser<Word, Options> GIVE{"/item", "give", {"item", "amount=1"}};
 }
 
-void ItemCommand::handleDefine(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 3) throw std::runtime_error("Usage: /item define <name> [type=generic]");
-    
-    std::string name = args[2];
-    auto params = CommandUtils::parseNamedParams(args, 3);
-    
+ItemCommand::ItemCommand() : CommandHandler("/item") {
+    subcommands.add(DEFINE, this, &ItemCommand::handleDefine);
+    subcommands.add(SET_PROPERTY, this, &ItemCommand::handleSetProperty);
+    subcommands.add(GIVE, this, &ItemCommand::handleGive);
+}
+
+CommandStatus ItemCommand::handleDefine(GameEngine& engine, const std::vector<std::string>&,
+                                        const std::string& name, CommandUtils::Params params) {
     GameObject item;
     item.type = "item";
     item.name = name;
-    item.display = params.count("display") ? params["display"][0] : '$';
+    item.setDisplay(params.get("display", "$"));
     
     // 设置默认属性
     static const std::unordered_map<std::string, int> DEFAULT_PROPS = {
         {"pickupable", 0}, {"stackable", 1}, {"value", 10}
     };
     for (const auto& [k, v] : DEFAULT_PROPS) {
-        if (!params.count(k)) item.setProperty(k, v);
+        if (!params.has(k)) item.setProperty(k, v);
     }
     
     // 应用自定义属性
-    for (const auto& [k, v] : params) {
+    params.forEach([&](std::string_view k, std::string_view v) {
         if (k != "name" && k != "display") {
-            item.setProperty(k, v);
+            item.setProperty(std::string(k), std::string(v));
         }
-    }
+    });
     
     engine.getItems()[name] = item;
-    std::string itemType = params.count("type") ? params.at("type") : "generic";
 
 #ifdef DEBUG
+    std::string_view itemType = params.get("type", "generic");
     Log log("debug.log");
     log.debug("物品 " , name , " 定义成功 (类型: " , itemType , ")");
     // 定义调试用的属性获取函数
@@ -67,22 +67,23 @@ void ItemCommand::handleDefine(const std::vector<std::string>& args, GameEngine&
     std::clog << " - Command: /item define " << name << "\n";
     std::clog << " - Item Name: " << name << "\n";
     std::clog << " - Type: " << itemType << "\n";
-    std::clog << " - Display: " << item.display << "\n";
+    std::clog << " - Display: " << item.getDisplayText() << "\n";
     std::clog << " - Pickupable: " << getPropString("pickupable") << "\n";
     std::clog << " - Stackable: " << getPropString("stackable") << "\n";
     std::clog << " - Value: " << getPropString("value") << std::endl;
 #endif
+    return CommandStatus::success();
 }
 
-void ItemCommand::handleSetProperty(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 4) throw std::runtime_error("Usage: /item setproperty <name> <property=value>...");
-    
-    std::string name = args[2];
-    auto params = CommandUtils::parseNamedParams(args, 3);
-    
+CommandStatus ItemCommand::handleSetProperty(GameEngine& engine, const std::vector<std::string>&,
+                                             const std::string& name, CommandUtils::Params params) {
     if (!engine.getItems().count(name)) {
-        throw std::runtime_error("未定义的物品: " + name);
+        return CommandStatus::failure("未定义的物品: " + name);
     }
+
+    // 先检查参数再修改，失败时物品保持不变
+    int damage = 0;
+    if (CommandStatus status = params.getInt("damage", damage); !status) return status;
     
     GameObject& item = engine.getItems()[name];
     
@@ -104,47 +105,47 @@ void ItemCommand::handleSetProperty(const std::vector<std::string>& args, GameEn
     std::clog << " - Command: /item setproperty " << name << "\n";
 #endif
     
-    for (const auto& [prop, value] : params) {
+    params.forEach([&](std::string_view prop, std::string_view value) {
 #ifdef DEBUG
-        std::string oldValue = getPropString(prop);
+        std::string oldValue = getPropString(std::string(prop));
 #endif
         // 处理特殊属性类型
         if (prop == "damage") {
-            item.setProperty("damage", std::to_string(std::stoi(value)));
+            item.setProperty("damage", std::to_string(damage));
         } else if (prop == "pickupable") {
             bool state = (value == "true" || value == "1" || value == "是");
             item.setProperty("pickupable", state ? 1 : 0);
         } else if (prop == "stackable" || prop == "value") {
-            item.setProperty(prop, value);
+            item.setProperty(std::string(prop), std::string(value));
         }
 #ifdef DEBUG
-        std::clog << " - 属性变更: " << prop << " | 旧值: " << oldValue << " → 新值: " << getPropString(prop) << "\n";
+        std::clog << " - 属性变更: " << prop << " | 旧值: " << oldValue << " → 新值: " << getPropString(std::string(prop)) << "\n";
 #endif
-    }
+    });
     
 #ifdef DEBUG
     Log log("debug.log");
     log.debug("已更新物品属性: ", name, "\n新属性: ", item.getFormattedProperties());
 #endif
+    return CommandStatus::success();
 }
 
-void ItemCommand::handleGive(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 3) throw std::runtime_error("Usage: /item give <item> [amount=1]");
-
-    const std::string& itemName = args[2];
+CommandStatus ItemCommand::handleGive(GameEngine& engine, const std::vector<std::string>& args,
+                                      const std::string& itemName, CommandUtils::Params params) {
     int amount = 1;
     
     // 解析数量参数
-    auto params = CommandUtils::parseNamedParams(args, 3);
-    if(params.count("amount")) {
-        amount = std::stoi(params["amount"]);
+    if(params.has("amount")) {
+        if (CommandStatus status = params.getInt("amount", amount); !status) return status;
     } else if(args.size() >= 4) {
-        amount = std::stoi(args[3]); // 兼容旧版位置参数
+        auto value = CommandUtils::toInt(args[3]); // 兼容旧版位置参数
+        if (!value) return CommandStatus::failure("数量必须是整数: " + args[3]);
+        amount = *value;
     }
     
     // 检查物品是否存在
     if (!engine.getItems().count(itemName)) {
-        throw std::runtime_error("未定义的物品: " + itemName);
+        return CommandStatus::failure("未定义的物品: " + itemName);
     }
     
     // 获取物品模板
@@ -162,7 +163,7 @@ void ItemCommand::handleGive(const std::vector<std::string>& args, GameEngine& e
                 Log log("debug.log");
                 log.debug("成功给予 ", std::to_string(amount), " 个 ", itemName);
 #endif
-                return;
+                return CommandStatus::success();
             }
         }
     }
@@ -176,4 +177,5 @@ void ItemCommand::handleGive(const std::vector<std::string>& args, GameEngine& e
     Log log("debug.log");
     log.debug("成功给予 ", std::to_string(amount), " 个 ", itemName);
 #endif
+    return CommandStatus::success();
 }
\ No newline at end of file
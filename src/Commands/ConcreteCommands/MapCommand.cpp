@@ -1,133 +1,160 @@
 // File: src/GameEngine/Commands/ConcreteCommands/MapCommand.cpp
 #include "MapCommand.h"
 #include "CommandUtils.h"
-#include <sstream>
+#include "GameEngine.h"
 
-void MapCommand::handle(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 2) throw std::runtime_error("Invalid map command");
+using namespace CommandSchema;
+
+namespace {
+const Parser<Word, Options> CREATE{"/map", "create", {"name", "width=20 height=20"}};
+const Parser<Word, Coord, Word, Options> SETBLOCK{"/map", "setblock", {"map", "x y", "type", "options..."}};
+const Parser<Word, Coord, Coord, Word, Options> FILL{"/map", "fill", {"map", "x1 y1", "x2 y2", "type", "options..."}};
+}
+
+MapCommand::MapCommand() : CommandHandler("/map") {
+    subcommands.add(CREATE, this, &MapCommand::handleCreate);
+    subcommands.add(SETBLOCK, this, &MapCommand::handleSetBlock);
+    subcommands.add(FILL, this, &MapCommand::handleFill);
+}
+
+CommandStatus MapCommand::apply(GameMap& map, const std::vector<std::string>& args,
+                               const std::map<std::string, GameObject>& items) {
+    if (args.size() < 2) return CommandStatus::failure("Invalid map command");
     
+    CommandStatus status;
     const std::string& subcmd = args[1];
     if (subcmd == "create") {
-        handleCreate(args, engine);
+        auto [name, params] = CREATE.parse(args, status);
+        if (status) status = buildMap(params, map);
     } else if (subcmd == "setblock") {
-        handleSetBlock(args, engine);
+        auto [name, pos, type, params] = SETBLOCK.parse(args, status);
+        if (status) status = placeBlock(map, pos, type, params, items);
     } else if (subcmd == "fill") {
-        handleFill(args, engine);
+        auto [name, from, to, type, params] = FILL.parse(args, status);
+        if (status) status = fillArea(map, from, to, type, params, items);
     }
+    return status;
 }
 
-void MapCommand::handleCreate(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 3) throw std::runtime_error("Usage: /map create <name> [width=20] [height=20]");
-    
-    std::string name = args[2];
-    int width = 20, height = 20;
-    auto params = CommandUtils::parseNamedParams(args, 3);
-    
-    if (params.count("width")) width = std::stoi(params["width"]);
-    if (params.count("height")) height = std::stoi(params["height"]);
-    
-    engine.getMaps()[name] = GameMap(width, height);
+std::optional<MapCommand::Placement> MapCommand::parsePlacement(const std::vector<std::string>& args) {
+    CommandStatus status;
+    if (args.size() >= 2 && args[1] == "setblock") {
+        auto [name, pos, type, params] = SETBLOCK.parse(args, status);
+        if (!status) return std::nullopt;
+        return Placement{name, pos.first, pos.second, pos.first, pos.second, type, params};
+    }
+    if (args.size() >= 2 && args[1] == "fill") {
+        auto [name, from, to, type, params] = FILL.parse(args, status);
+        if (!status) return std::nullopt;
+        return Placement{name, from.first, from.second, to.first, to.second, type, params};
+    }
+    return std::nullopt;
+}
+
+// 加载脚本期间，非主地图的构建命令先记录下来，首次进入地图时再执行
+CommandStatus MapCommand::handleCreate(GameEngine& engine, const std::vector<std::string>& args,
+                                       const std::string& name, CommandUtils::Params params) {
+    if (engine.deferMapCommand(args)) return CommandStatus::success();
+    GameMap map;
+    if (CommandStatus status = buildMap(params, map); !status) return status;
+    engine.getMap(name) = std::move(map);
     
 #ifdef DEBUG
     Log log("debug.log");
     log.debug("地图 ", name, " 创建成功 ");
 #endif
+    return CommandStatus::success();
 }
 
-void MapCommand::handleSetBlock(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 6) throw std::runtime_error("Usage: /map setblock <map> <x> <y> <type> [options...]");
-    
-    std::string mapName = args[2];
-    auto [x, y] = CommandUtils::parseCoordinates(args, 3);
-    std::string type = args[5];
-    auto params = CommandUtils::parseNamedParams(args, 6);
+CommandStatus MapCommand::handleSetBlock(GameEngine& engine, const std::vector<std::string>& args, const std::string& mapName,
+                                         std::pair<int, int> pos, const std::string& type, CommandUtils::Params params) {
+    if (engine.deferMapCommand(args)) return CommandStatus::success();
+    return placeBlock(engine.getMap(mapName), pos, type, params, engine.getItems());
+}
+
+CommandStatus MapCommand::handleFill(GameEngine& engine, const std::vector<std::string>& args, const std::string& mapName,
+                                     std::pair<int, int> from, std::pair<int, int> to, const std::string& type,
+                                     CommandUtils::Params params) {
+    if (engine.deferMapCommand(args)) return CommandStatus::success();
+    if (CommandStatus status = fillArea(engine.getMap(mapName), from, to, type, params, engine.getItems()); !status) {
+        return status;
+    }
     
-    GameObject obj;
+#ifdef DEBUG
+    Log log("debug.log");
+    log.debug("填充操作完成");
+#endif
+    return CommandStatus::success();
+}
+
+CommandStatus MapCommand::buildMap(CommandUtils::Params params, GameMap& map) {
+    int width = 20, height = 20;
+    if (CommandStatus status = params.getInt("width", width); !status) return status;
+    if (CommandStatus status = params.getInt("height", height); !status) return status;
+    map.clear(); // 重建前释放原有实体的ID
+    map = GameMap(width, height);
+    return CommandStatus::success();
+}
+
+CommandStatus MapCommand::makeObject(const std::string& type, CommandUtils::Params params,
+                                     const std::map<std::string, GameObject>& items,
+                                     const std::unordered_map<std::string, char>& displays, GameObject& obj) {
     if (type == "item") {
-        if (!engine.getItems().count(params["name"])) {
-            throw std::runtime_error("未定义的物品: " + params["name"]);
+        const std::string name(params.get("name"));
+        auto it = items.find(name);
+        if (it == items.end()) {
+            return CommandStatus::failure("未定义的物品: " + name);
         }
-        obj = engine.getItems()[params["name"]];
+        obj = it->second;
     } else {
         obj.type = type;
     }
-    obj.x = x;
-    obj.y = y;
     
-    if (params.count("name")) obj.name = params["name"];
+    if (auto name = params.find("name")) obj.name = *name;
     
     // 设置显示字符
-    if (params.count("display")) {
-        obj.display = params["display"][0];
+    if (auto display = params.find("display")) {
+        obj.setDisplay(*display);
     } else {
-        static std::unordered_map<std::string, char> defaults = {
-            {"wall", '#'}, {"npc", '@'}, {"item", '$'},
-            {"trap", '^'}, {"marker", '*'}
-        };
-        obj.display = defaults.count(type) ? defaults[type] : '?';
+        auto it = displays.find(type);
+        obj.display = it != displays.end() ? it->second : '?';
     }
     
     // 设置属性
     if (type == "wall") {
         obj.setProperty("walkable", 0);
     } else if (type == "trap") {
-        int damage = params.count("damage") ? std::stoi(params["damage"]) : 10;
+        int damage = 10;
+        if (CommandStatus status = params.getInt("damage", damage); !status) return status;
         obj.setProperty("damage", damage);
         obj.setProperty("walkable", 1);
     }
-    
-    engine.getMaps()[mapName].setObject(x, y, obj);
+    return CommandStatus::success();
 }
 
-void MapCommand::handleFill(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 7) throw std::runtime_error("Usage: /map fill <map> <from x y> <to x y> <type> [options...]");
-    
-    std::string mapName = args[2];
-    auto [x1, y1] = CommandUtils::parseCoordinates(args, 3);
-    auto [x2, y2] = CommandUtils::parseCoordinates(args, 4);
-    std::string type = args[5];
-    auto params = CommandUtils::parseNamedParams(args, 6);
-    
+CommandStatus MapCommand::placeBlock(GameMap& map, std::pair<int, int> pos, const std::string& type,
+                                     CommandUtils::Params params, const std::map<std::string, GameObject>& items) {
     GameObject obj;
-    if (type == "item") {
-        if (!engine.getItems().count(params["name"])) {
-            throw std::runtime_error("未定义的物品: " + params["name"]);
-        }
-        obj = engine.getItems()[params["name"]];
-    } else {
-        obj.type = type;
-    }
+    if (CommandStatus status = makeObject(type, params, items, DEFAULT_DISPLAYS, obj); !status) return status;
+    obj.x = pos.first;
+    obj.y = pos.second;
     
-    if (params.count("name")) obj.name = params["name"];
-    
-    // 设置显示字符
-    if (params.count("display")) {
-        obj.display = params["display"][0];
-    } else {
-        static std::unordered_map<std::string, char> defaults = {
-            {"wall", '#'}, {"trap", '^'}
-        };
-        obj.display = defaults.count(type) ? defaults[type] : '?';
-    }
-    
-    // 设置属性
-    if (type == "wall") {
-        obj.setProperty("walkable", 0);
-    } else if (type == "trap") {
-        int damage = params.count("damage") ? std::stoi(params["damage"]) : 10;
-        obj.setProperty("damage", damage);
-        obj.setProperty("walkable", 1);
-    }
+    map.setObject(pos.first, pos.second, obj);
+    return CommandStatus::success();
+}
+
+CommandStatus MapCommand::fillArea(GameMap& map, std::pair<int, int> from, std::pair<int, int> to, const std::string& type,
+                                   CommandUtils::Params params, const std::map<std::string, GameObject>& items) {
+    GameObject obj;
+    if (CommandStatus status = makeObject(type, params, items, FILL_DISPLAYS, obj); !status) return status;
     
     // 填充区域
+    auto [x1, y1] = from;
+    auto [x2, y2] = to;
     for (int x = std::min(x1, x2); x <= std::max(x1, x2); ++x) {
         for (int y = std::min(y1, y2); y <= std::max(y1, y2); ++y) {
-            engine.getMaps()[mapName].setObject(x, y, obj);
+            map.setObject(x, y, obj);
         }
     }
-    
-#ifdef DEBUG
-    Log log("debug.log");
-    log.debug("填充操作完成");
-#endif
+    return CommandStatus::success();
 }
\ No newline at end of file
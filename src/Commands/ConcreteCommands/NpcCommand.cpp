@@ -3,31 +3,31 @@
 #include "CommandUtils.h"
 #include <sstream>
 
-void NpcCommand::handle(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 2) throw std::runtime_error("Usage: /npc <create|setdialogue|...>");
-    
-    const std::string& subcmd = args[1];
-    if (subcmd == "create") handleCreate(args, engine);
-    else if (subcmd == "setdialogue") handleSetDialogue(args, engine);
-    else throw std::runtime_error("未知子命令: " + subcmd);
+using namespace CommandSchema;
+
+namespace {
+const Parser<Word, Options> CREATE{"/npc", "create", {"name", "template=default"}};
+// 对话内容每个参数一行（引号内的空格不分行）
+const Parser<Word, Word, Lines> SET_DIALOGUE{"/npc", "setdialogue", {"name", "condition", "dialogue..."}};
 }
 
-void NpcCommand::handleCreate(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 3) throw std::runtime_error("Usage: /npc create <name> [template=default]");
-    
-    std::string name = args[2];
-    auto params = CommandUtils::parseNamedParams(args, 3);
-    
+NpcCommand::NpcCommand() : CommandHandler("/npc") {
+    subcommands.add(CREATE, this, &NpcCommand::handleCreate);
+    subcommands.add(SET_DIALOGUE, this, &NpcCommand::handleSetDialogue);
+}
+
+CommandStatus NpcCommand::handleCreate(GameEngine& engine, const std::vector<std::string>&,
+                                       const std::string& name, CommandUtils::Params params) {
     GameObject npc;
     npc.type = "npc";
     npc.name = name;
     npc.display = '@';
     
     // 应用模板（如果指定）
-    if (params.count("template")) {
-        const std::string& tpl = params["template"];
-        if (engine.getNpcs().count(tpl)) {
-            npc = engine.getNpcs().at(tpl);
+    if (auto tpl = params.find("template")) {
+        auto it = engine.getNpcs().find(std::string(*tpl));
+        if (it != engine.getNpcs().end()) {
+            npc = it->second;
             npc.name = name; // 保留指定名称
         }
     }
@@ -37,30 +37,21 @@ void NpcCommand::handleCreate(const std::vector<std::string>& args, GameEngine&
     Log log("debug.log");
     log.debug("NPC ", name, "创建成功");
 #endif
+    return CommandStatus::success();
 }
 
-void NpcCommand::handleSetDialogue(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 5) throw std::runtime_error("Usage: /npc setdialogue <name> <condition> <dialogue>");
-    
-    std::string name = args[2];
-    std::string condition = args[3];
-    
-    // 合并对话内容
-    std::string dialogue;
-    for (size_t i = 4; i < args.size(); ++i) {
-        if (i > 4) dialogue += " ";
-        dialogue += args[i];
-    }
-    
+CommandStatus NpcCommand::handleSetDialogue(GameEngine& engine, const std::vector<std::string>&,
+                                            const std::string& name, const std::string& condition, std::string dialogue) {
     // 检查NPC是否存在
     if (!engine.getNpcs().count(name)) {
-        throw std::runtime_error("NPC不存在: " + name);
+        return CommandStatus::failure("NPC不存在: " + name);
     }
     
     // 设置对话内容
-    engine.getNpcs()[name].dialogues[condition] = dialogue;
+    engine.getNpcs()[name].dialogues[condition] = std::move(dialogue);
 #ifdef DEBUG
     Log log("debug.log");
     log.debug("已为NPC", name, "设置对话条件: ", condition);
 #endif
+    return CommandStatus::success();
 }
\ No newline at end of file
@@ -0,0 +1,63 @@
+// File: src/GameEngine/Commands/ConcreteCommands/ScheduleCommand.cpp
+#include "ScheduleCommand.h"
+#include "CommandParser.h"
+#include "GameEngine.h"
+#include <algorithm>
+
+using namespace CommandSchema;
+
+namespace {
+const Parser<Word, Count, Setting, Tokens> ADD{"/schedule", "add", {"name", "ticks", "every=interval", "command..."}};
+const Parser<Word> CANCEL{"/schedule", "cancel", {"name"}};
+const Parser<> LIST{"/schedule", "list", {}};
+}
+
+ScheduleCommand::ScheduleCommand() : CommandHandler("/schedule") {
+    subcommands.add(ADD, this, &ScheduleCommand::handleAdd);
+    subcommands.add(CANCEL, this, &ScheduleCommand::handleCancel);
+    subcommands.add(LIST, this, &ScheduleCommand::handleList);
+}
+
+CommandStatus ScheduleCommand::handleAdd(GameEngine& engine, const std::vector<std::string>&, const std::string& name,
+                                         int delay, std::optional<std::string> every, std::vector<std::string> command) {
+    int interval = 0;
+    if (every) {
+        auto value = Count::convert(*every);
+        if (!value) return CommandStatus::failure("every必须是正整数: " + *every);
+        interval = *value;
+    }
+
+    // 添加时即编译，到期时直接执行
+    CompiledCommand compiled = CommandParser::compile(std::move(command));
+    if (!compiled.handler) return CommandStatus::failure("未知命令: " + compiled.args[0]);
+    engine.getScheduler().schedule(name, static_cast<std::uint32_t>(delay), static_cast<std::uint32_t>(interval),
+                                   std::move(compiled));
+    return CommandStatus::success();
+}
+
+CommandStatus ScheduleCommand::handleCancel(GameEngine& engine, const std::vector<std::string>&, const std::string& name) {
+    if (!engine.getScheduler().cancel(name)) return CommandStatus::failure("定时命令不存在: " + name);
+    return CommandStatus::success();
+}
+
+CommandStatus ScheduleCommand::handleList(GameEngine& engine, const std::vector<std::string>&) {
+    std::vector<Scheduler::TimerInfo> timers = engine.getScheduler().list();
+    if (timers.empty()) {
+        engine.getDialogSystem().showDialog({{"没有定时命令"}, "定时命令"}, engine);
+        return CommandStatus::success();
+    }
+
+    // 按到期先后显示
+    std::stable_sort(timers.begin(), timers.end(),
+                     [](const auto& a, const auto& b) { return a.remaining < b.remaining; });
+    std::string text;
+    for (const auto& timer : timers) {
+        if (!text.empty()) text += "\n";
+        text += timer.name + ": " + std::to_string(timer.remaining) + "回合后";
+        if (timer.interval > 0) text += "，每" + std::to_string(timer.interval) + "回合";
+        text += " →";
+        for (const auto& arg : timer.command->args) text += " " + arg;
+    }
+    engine.getDialogSystem().showDialog({{text}, "定时命令"}, engine);
+    return CommandStatus::success();
+}
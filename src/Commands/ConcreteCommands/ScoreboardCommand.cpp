@@ -1,101 +1,130 @@
 // File: src/GameEngine/Commands/ConcreteCommands/ScoreboardCommand.cpp
 #include "ScoreboardCommand.h"
 #include "GameEngine.h"
+#include "EntitySelector.h"
 
-void ScoreboardCommand::handle(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 2) {
-        throw std::runtime_error("Usage: /scoreboard <add|set|operation>");
-    }
+using namespace CommandSchema;
 
-    const std::string& subcmd = args[1];
-    if (subcmd == "add") {
-        handleAdd(args, engine);
-    } else if (subcmd == "set") {
-        handleSet(args, engine);
-    } else if (subcmd == "operation") {
-        handleOperation(args, engine);
-    } else {
-        throw std::runtime_error("未知子命令: " + subcmd);
-    }
+namespace {
+const Parser<Word> ADD{"/scoreboard", "add", {"variable"}};
+const Parser<Word, Text> SET{"/scoreboard", "set", {"variable", "value..."}};
+const Parser<Word, Word, Text> SET_ENTITY{"/scoreboard", "set", {"selector", "objective", "value..."}};
+const Parser<Word, Word, Text> OPERATION{"/scoreboard", "operation", {"variable", "op", "expression..."}};
+const Parser<Word, Word, Word, Text> OPERATION_ENTITY{"/scoreboard", "operation",
+                                                      {"selector", "objective", "op", "expression..."}};
+const Parser<Keyword, Word, Options> OBJECTIVES{"/scoreboard", "objectives", {"add", "objective", "default=0"}};
 }
 
-void ScoreboardCommand::handleAdd(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 3) {
-        throw std::runtime_error("Usage: /scoreboard add <variable>");
-    }
-    engine.getVariables()[args[2]] = 0;
+ScoreboardCommand::ScoreboardCommand() : CommandHandler("/scoreboard") {
+    subcommands.add(ADD, this, &ScoreboardCommand::handleAdd);
+    subcommands.add(SET, this, &ScoreboardCommand::handleSet);
+    subcommands.add(SET_ENTITY, this, &ScoreboardCommand::handleEntitySet, true);
+    subcommands.add(OPERATION, this, &ScoreboardCommand::handleOperation);
+    subcommands.add(OPERATION_ENTITY, this, &ScoreboardCommand::handleEntityOperation, true);
+    subcommands.add(OBJECTIVES, this, &ScoreboardCommand::handleObjectives);
+}
+
+CommandStatus ScoreboardCommand::handleAdd(GameEngine& engine, const std::vector<std::string>&, const std::string& varName) {
+    engine.getVariables()[varName] = 0;
+#ifdef DEBUG
+    Log log("debug.log");
+    log.debug("已创建变量: ", varName);
+#endif
+    return CommandStatus::success();
+}
+
+CommandStatus ScoreboardCommand::handleSet(GameEngine& engine, const std::vector<std::string>&,
+                                           const std::string& varName, std::string expr) {
+    int value = ConditionEvaluator::evaluateExpression(engine, expr);
+    engine.getVariables()[varName] = value;
 #ifdef DEBUG
     Log log("debug.log");
-    log.debug("已创建变量: ", args[2]);
+    log.debug(varName, "=", std::to_string(value));
 #endif
+    return CommandStatus::success();
 }
 
-void ScoreboardCommand::handleSet(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 4) {
-        throw std::runtime_error("Usage: /scoreboard set <variable> <value>");
+CommandStatus ScoreboardCommand::handleOperation(GameEngine& engine, const std::vector<std::string>&,
+                                                 const std::string& varName, const std::string& op, std::string exprStr) {
+    int value = ConditionEvaluator::evaluateExpression(engine, exprStr);
+    auto& variables = engine.getVariables();
+    auto it = variables.find(varName);
+    if (it == variables.end()) {
+        return CommandStatus::failure("操作执行失败: 未定义的变量: " + varName);
     }
-    
-    std::string expr;
-    for (size_t i = 3; i < args.size(); ++i) {
-        if (i > 3) expr += " ";
-        expr += args[i];
+
+    int& variable = it->second;
+    if (op == "=") {
+        variable = value;
+    } else if (op == "+=") {
+        variable += value;
+    } else if (op == "-=") {
+        variable -= value;
+    } else if (op == "*=") {
+        variable *= value;
+    } else if (op == "/=") {
+        if (value == 0) return CommandStatus::failure("操作执行失败: 除数不能为零");
+        variable /= value;
+    } else {
+        return CommandStatus::failure("操作执行失败: 未知操作符: " + op);
     }
     
-    try {
-        int value = ConditionEvaluator::evaluateExpression(engine, expr);
-        engine.getVariables()[args[2]] = value;
 #ifdef DEBUG
-        Log log("debug.log");
-        log.debug(args[2], "=", std::to_string(value));
+    Log log("debug.log");
+    log.debug(varName, " ", op, " ", std::to_string(value), " → ", std::to_string(variable));
 #endif
-    } catch (const std::exception& e) {
-        throw std::runtime_error("表达式计算失败: " + std::string(e.what()));
-    }
+    return CommandStatus::success();
 }
 
-void ScoreboardCommand::handleOperation(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 5) {
-        throw std::runtime_error("Usage: /scoreboard operation <variable> <op> <expression>");
+CommandStatus ScoreboardCommand::handleObjectives(GameEngine& engine, const std::vector<std::string>& args,
+                                                  const std::string&, const std::string& objective,
+                                                  CommandUtils::Params params) {
+    int defaultValue = 0;
+    if (params.has("default")) {
+        if (CommandStatus status = params.getInt("default", defaultValue); !status) return status;
+    } else if (args.size() >= 5) {
+        // 兼容旧版位置参数
+        auto value = CommandUtils::toInt(args[4]);
+        if (!value) return CommandStatus::failure("默认值必须是整数: " + args[4]);
+        defaultValue = *value;
     }
-
-    const std::string& varName = args[2];
-    const std::string& op = args[3];
     
-    // 构建表达式
-    std::string exprStr;
-    for (size_t i = 4; i < args.size(); ++i) {
-        if (i > 4) exprStr += " ";
-        exprStr += args[i];
-    }
+    engine.getScoreboard().addObjective(objective, defaultValue);
+#ifdef DEBUG
+    Log log("debug.log");
+    log.debug("已创建计分项: ", objective, " 默认值: ", std::to_string(defaultValue));
+#endif
+    return CommandStatus::success();
+}
 
-    try {
-        int value = ConditionEvaluator::evaluateExpression(engine, exprStr);
-        auto& variables = engine.getVariables();
-        
-        if (variables.find(varName) == variables.end()) {
-            throw std::runtime_error("未定义的变量: " + varName);
-        }
+CommandStatus ScoreboardCommand::handleEntitySet(GameEngine& engine, const std::vector<std::string>& args,
+                                                 const std::string& selector, const std::string& objective,
+                                                 std::string exprStr) {
+    return handleEntityOperation(engine, args, selector, objective, "=", std::move(exprStr));
+}
 
-        if (op == "=") {
-            variables[varName] = value;
-        } else if (op == "+=") {
-            variables[varName] += value;
-        } else if (op == "-=") {
-            variables[varName] -= value;
-        } else if (op == "*=") {
-            variables[varName] *= value;
-        } else if (op == "/=") {
-            if (value == 0) throw std::runtime_error("除数不能为零");
-            variables[varName] /= value;
-        } else {
-            throw std::runtime_error("未知操作符: " + op);
-        }
-        
+CommandStatus ScoreboardCommand::handleEntityOperation(GameEngine& engine, const std::vector<std::string>&,
+                                                       const std::string& selector, const std::string& objective,
+                                                       const std::string& op, std::string exprStr) {
+    if (!engine.getScoreboard().hasObjective(objective)) {
+        return CommandStatus::failure("未定义的计分项: " + objective);
+    }
+    if (op != "=" && op != "+=" && op != "-=" && op != "*=" && op != "/=") {
+        return CommandStatus::failure("未知操作符: " + op);
+    }
+    
+    // 表达式只计算一次，再对所有命中实体整列运算
+    int value = ConditionEvaluator::evaluateExpression(engine, exprStr);
+    if (op == "/=" && value == 0) return CommandStatus::failure("除数不能为零");
+    std::vector<Scoreboard::EntityId> ids;
+    for (const SelectedEntity& entity : EntitySelector::parse(selector).select(engine)) {
+        ids.push_back(engine.getScoreboard().track(entity.object));
+    }
+    engine.getScoreboard().apply(objective, op, ids, value);
+    
 #ifdef DEBUG
-        Log log("debug.log");
-        log.debug(varName, " ", op, " ", std::to_string(value), " → ", std::to_string(variables[varName]));
+    Log log("debug.log");
+    log.debug(selector, " ", objective, " ", op, " ", std::to_string(value), " (", std::to_string(ids.size()), " 个实体)");
 #endif
-    } catch (const std::exception& e) {
-        throw std::runtime_error("操作执行失败: " + std::string(e.what()));
-    }
-}
\ No newline at end of file
+    return CommandStatus::success();
+}
@@ -1,31 +1,35 @@
 // File: src/GameEngine/Commands/ConcreteCommands/TeleportCommand.cpp
 #include "TeleportCommand.h"
 #include "GameEngine.h"
-#include <stdexcept>
 
-void TeleportCommand::handle(const std::vector<std::string>& args, GameEngine& engine) {
-    // 参数验证
-    if (args.size() < 4) {
-        throw std::runtime_error("Usage: /teleport <map> <x> <y>");
-    }
+using namespace CommandSchema;
+
+namespace {
+const Parser<Word, Coord> TELEPORT{"/teleport", "", {"map", "x y"}};
+}
+
+TeleportCommand::TeleportCommand() : CommandHandler("/teleport", false) {
+    subcommands.add(TELEPORT, this, &TeleportCommand::handleTeleport);
+}
 
-    // 解析参数
-    const std::string& mapName = args[1];
-    auto [x, y] = CommandUtils::parseCoordinates(args, 2);
+CommandStatus TeleportCommand::handleTeleport(GameEngine& engine, const std::vector<std::string>&,
+                                              const std::string& mapName, std::pair<int, int> pos) {
+    auto [x, y] = pos;
 
     // 地图存在性检查
-    if (!engine.getMaps().count(mapName)) {
-        throw std::runtime_error("地图不存在: " + mapName);
+    if (!engine.hasMap(mapName)) {
+        return CommandStatus::failure("地图不存在: " + mapName);
     }
 
-    // 执行传送逻辑
-    engine.setCurrentMap(mapName);
+    // 执行传送逻辑（先设置位置，进入地图事件中可读到新位置）
     engine.setPlayerX(x);
     engine.setPlayerY(y);
+    engine.setCurrentMap(mapName);
 
     // 显示反馈
 #ifdef DEBUG
     Log log("debug.log");
     log.debug("已传送到", mapName, " (" + std::to_string(x) , "," + std::to_string(y) , ")");
 #endif
+    return CommandStatus::success();
 }
\ No newline at end of file
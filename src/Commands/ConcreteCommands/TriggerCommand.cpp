@@ -3,31 +3,23 @@
 #include "CommandUtils.h"
 #include "GameEngine.h"
 
-void TriggerCommand::handle(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 3) {
-        throw std::runtime_error("Usage: /trigger <event> [args...]");
-    }
+using namespace CommandSchema;
 
-    const std::string& event = args[1];
-    
-    if (event == "npc.interact") {
-        handleNpcInteract(args, engine);
-    } else {
-        throw std::runtime_error("未知事件: " + event);
-    }
+namespace {
+const Parser<Word, Optional<Word>> NPC_INTERACT{"/trigger", "npc.interact", {"name", "condition"}};
 }
 
-void TriggerCommand::handleNpcInteract(const std::vector<std::string>& args, GameEngine& engine) {
-    if (args.size() < 3) {
-        throw std::runtime_error("Usage: /trigger npc.interact <name> [condition]");
-    }
+TriggerCommand::TriggerCommand() : CommandHandler("/trigger") {
+    subcommands.add(NPC_INTERACT, this, &TriggerCommand::handleNpcInteract);
+}
 
-    std::string name = args[2];
-    std::string condition = args.size() > 3 ? args[3] : "always";
+CommandStatus TriggerCommand::handleNpcInteract(GameEngine& engine, const std::vector<std::string>&,
+                                                const std::string& name, std::optional<std::string> optionalCondition) {
+    const std::string condition = optionalCondition.value_or("always");
 
     auto& npcs = engine.getNpcs();
     if (!npcs.count(name)) {
-        throw std::runtime_error("NPC不存在: " + name);
+        return CommandStatus::failure("NPC不存在: " + name);
     }
 
     auto& npc = npcs[name];
@@ -36,4 +28,5 @@ void TriggerCommand::handleNpcInteract(const std::vector<std::string>& args, Gam
     } else {
         engine.getDialogSystem().showDialog({{"..."}, name}, engine);
     }
+    return CommandStatus::success();
 }
\ No newline at end of file
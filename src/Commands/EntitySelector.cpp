@@ -0,0 +1,242 @@
+// src/Commands/EntitySelector.cpp
+#include "EntitySelector.h"
+#include "GameEngine.h"
+#include <cstdlib>
+#include <stdexcept>
+#include <variant>
+
+using namespace std;
+
+namespace {
+
+const GameMap::PositionSet EMPTY_POSITIONS;
+
+// 将属性值转换为数字，无法转换时返回false
+bool toNumber(const GameObject::PropertyValue& value, double& out) {
+    return visit([&](auto&& arg) -> bool {
+        using T = decay_t<decltype(arg)>;
+        if constexpr (is_same_v<T, string>) {
+            if (arg.empty()) return false;
+            char* end = nullptr;
+            out = strtod(arg.c_str(), &end);
+            return *end == '\0';
+        } else {
+            out = static_cast<double>(arg);
+            return true;
+        }
+    }, value);
+}
+
+string toText(const GameObject::PropertyValue& value) {
+    return visit([](auto&& arg) -> string {
+        using T = decay_t<decltype(arg)>;
+        if constexpr (is_same_v<T, string>) return arg;
+        else if constexpr (is_same_v<T, bool>) return arg ? "true" : "false";
+        else return to_string(arg);
+    }, value);
+}
+
+int parseInt(const string& key, const string& value) {
+    try {
+        size_t pos;
+        int result = stoi(value, &pos);
+        if (pos == value.size()) return result;
+    } catch (...) {}
+    throw runtime_error("选择器参数不是整数: " + key + "=" + value);
+}
+
+} // namespace
+
+EntitySelector EntitySelector::parse(const string& text) {
+    if (!isSelector(text)) throw runtime_error("无效的选择器: " + text);
+
+    EntitySelector selector;
+    if (text.size() == 2) return selector;
+    if (text[2] != '[' || text.back() != ']') throw runtime_error("无效的选择器: " + text);
+
+    string body = text.substr(3, text.size() - 4);
+    size_t start = 0;
+    while (start <= body.size()) {
+        size_t comma = body.find(',', start);
+        if (comma == string::npos) comma = body.size();
+        string item = body.substr(start, comma - start);
+        start = comma + 1;
+        if (item.empty()) continue;
+
+        // 属性比较 prop:key<op>value
+        if (item.rfind("prop:", 0) == 0) {
+            size_t opPos = item.find_first_of("<>=!", 5);
+            if (opPos == string::npos || opPos == 5) throw runtime_error("无效的属性条件: " + item);
+            size_t opLen = (opPos + 1 < item.size() && item[opPos + 1] == '=') ? 2 : 1;
+            PropertyFilter filter{item.substr(5, opPos - 5), item.substr(opPos, opLen), item.substr(opPos + opLen)};
+            if (filter.op == "!") throw runtime_error("无效的属性条件: " + item);
+            selector.properties.push_back(std::move(filter));
+            continue;
+        }
+
+        size_t eq = item.find('=');
+        if (eq == string::npos) throw runtime_error("选择器参数缺少'=': " + item);
+        string key = item.substr(0, eq);
+        string value = item.substr(eq + 1);
+
+        if (key == "type") selector.type = value;
+        else if (key == "name") selector.name = value;
+        else if (key == "map") selector.map = value;
+        else if (key == "x") selector.x = parseInt(key, value);
+        else if (key == "y") selector.y = parseInt(key, value);
+        else if (key == "r") selector.radius = parseInt(key, value);
+        else if (key == "limit") selector.limit = static_cast<size_t>(max(0, parseInt(key, value)));
+        else throw runtime_error("未知选择器参数: " + key);
+    }
+    if (selector.radius && *selector.radius < 0) throw runtime_error("选择器半径不能为负数");
+    return selector;
+}
+
+bool EntitySelector::compareProperty(const GameObject::PropertyValue& value, const PropertyFilter& filter) {
+    const string& op = filter.op;
+    double lhs, rhs;
+    GameObject::PropertyValue expected = filter.value;
+    if (toNumber(value, lhs) && toNumber(expected, rhs)) {
+        if (op == "=" || op == "==") return lhs == rhs;
+        if (op == "!=") return lhs != rhs;
+        if (op == "<")  return lhs < rhs;
+        if (op == "<=") return lhs <= rhs;
+        if (op == ">")  return lhs > rhs;
+        if (op == ">=") return lhs >= rhs;
+        return false;
+    }
+    // 非数字只支持相等比较
+    if (op == "=" || op == "==") return toText(value) == filter.value;
+    if (op == "!=") return toText(value) != filter.value;
+    return false;
+}
+
+bool EntitySelector::matches(const GameObject& obj, int centerX, int centerY) const {
+    if (type && obj.type != *type) return false;
+    if (name && obj.name != *name) return false;
+    if (isSpatial()) {
+        long dx = obj.x - centerX;
+        long dy = obj.y - centerY;
+        long r = radius.value_or(0);
+        if (dx * dx + dy * dy > r * r) return false;
+    }
+    for (const auto& filter : properties) {
+        auto it = obj.properties.find(filter.key);
+        if (it == obj.properties.end() || !compareProperty(it->second, filter)) return false;
+    }
+    return true;
+}
+
+EntitySelector::Iterator::Iterator(GameEngine& engine, const EntitySelector& selector)
+    : selector(&selector), done(false)
+{
+    centerX = selector.x.value_or(engine.getPlayerX());
+    centerY = selector.y.value_or(engine.getPlayerY());
+
+    // 确定需要查找的地图范围（只构建涉及的地图）
+    if (selector.map || selector.isSpatial()) {
+        const std::string& mapName = selector.map ? *selector.map : engine.getCurrentMapName();
+        if (engine.hasMap(mapName)) engine.getMap(mapName);
+        auto& maps = engine.getLoadedMaps();
+        mapIt = maps.find(mapName);
+        mapEnd = mapIt == maps.end() ? mapIt : std::next(mapIt);
+    } else {
+        auto& maps = engine.getMaps();
+        mapIt = maps.begin();
+        mapEnd = maps.end();
+    }
+    enterMap();
+    advance();
+}
+
+SelectedEntity EntitySelector::Iterator::operator*() const {
+    return {mapIt->first, mapIt->second, current->second};
+}
+
+EntitySelector::Iterator& EntitySelector::Iterator::operator++() {
+    advance();
+    return *this;
+}
+
+void EntitySelector::Iterator::enterMap() {
+    if (mapIt == mapEnd) {
+        done = true;
+        return;
+    }
+    GameMap& gameMap = mapIt->second;
+    auto& objects = objectsOf(gameMap);
+    const int r = selector->radius.value_or(0);
+    const long area = (2L * r + 1) * (2L * r + 1);
+
+    // 选择候选来源：名称索引 > 类型索引(比范围更小时) > 坐标条带 > 全量遍历
+    bucket = nullptr;
+    if (selector->name) {
+        bucket = gameMap.positionsByName(*selector->name);
+        if (!bucket) bucket = &EMPTY_POSITIONS;
+    } else if (selector->type) {
+        bucket = gameMap.positionsByType(*selector->type);
+        if (!bucket) bucket = &EMPTY_POSITIONS;
+        else if (selector->isSpatial() && static_cast<long>(bucket->size()) > area) bucket = nullptr;
+    }
+
+    if (bucket) {
+        bucketIt = bucket->begin();
+    } else if (selector->isSpatial()) {
+        objectIt = objects.lower_bound({centerX - r, centerY - r});
+        objectEnd = objects.upper_bound({centerX + r, centerY + r});
+    } else {
+        objectIt = objects.begin();
+        objectEnd = objects.end();
+    }
+}
+
+bool EntitySelector::Iterator::nextCandidate() {
+    auto& objects = objectsOf(mapIt->second);
+    if (bucket) {
+        while (bucketIt != bucket->end()) {
+            auto it = objects.find(*bucketIt++);
+            if (it != objects.end()) {
+                current = it;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const int r = selector->radius.value_or(0);
+    while (objectIt != objectEnd) {
+        const auto& [x, y] = objectIt->first;
+        // 坐标条带内按列跳跃，跳过y超出范围的对象
+        if (selector->isSpatial() && y < centerY - r) {
+            objectIt = objects.lower_bound({x, centerY - r});
+        } else if (selector->isSpatial() && y > centerY + r) {
+            objectIt = objects.lower_bound({x + 1, centerY - r});
+        } else {
+            current = objectIt++;
+            return true;
+        }
+        // 跳跃可能越过条带终点
+        if (objectIt == objects.end() || (objectEnd != objects.end() && !(objectIt->first < objectEnd->first))) {
+            objectIt = objectEnd;
+        }
+    }
+    return false;
+}
+
+void EntitySelector::Iterator::advance() {
+    while (!done) {
+        if (selector->limit && yielded >= *selector->limit) {
+            done = true;
+            return;
+        }
+        if (nextCandidate()) {
+            if (selector->matches(current->second, centerX, centerY)) {
+                ++yielded;
+                return;
+            }
+            continue;
+        }
+        ++mapIt;
+        enterMap();
+    }
+}
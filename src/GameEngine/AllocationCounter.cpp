@@ -0,0 +1,58 @@
+// src/GameEngine/AllocationCounter.cpp
+// 替换全局分配函数以统计分配次数（按线程，见LoadProfiler::counters；对齐分配不计数）
+// 只链接进基准测试和开启GAME_COUNT_ALLOCATIONS的游戏本体，默认构建不替换operator new
+#include "LoadProfiler.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+// 与标准库的operator new一致：分配失败时反复调用new_handler，没有handler时抛出bad_alloc
+void* allocate(std::size_t size) {
+    if (size == 0) size = 1;
+    for (;;) {
+        if (void* p = std::malloc(size)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+[[maybe_unused]] const bool linked = (LoadProfiler::allocationsCounted = true);
+}
+
+void* operator new(std::size_t size) {
+    ++LoadProfiler::counters().allocations;
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return ::operator new(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
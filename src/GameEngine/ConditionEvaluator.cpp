@@ -1,117 +1,531 @@
 // src/GameEngine/ConditionEvaluator.cpp
 #include "ConditionEvaluator.h"
 #include "GameEngine.h"
-#include "Log.h"
-#include <regex>
+#include "PluginHost.h"
 #include <algorithm>
-#include <sstream>
-#include <variant>
+#include <cctype>
+#include <climits>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
 
 using namespace std;
 
-vector<string> ConditionEvaluator::tokenize(const string& line) {
-    istringstream iss(line);
-    return {istream_iterator<string>{iss}, istream_iterator<string>{}};
+using Op = CompiledCondition::Op;
+using Node = CompiledCondition::Node;
+
+unordered_map<string, CompiledCondition> ConditionEvaluator::conditionCache;
+unordered_map<string, CompiledCondition> ConditionEvaluator::expressionCache;
+
+namespace {
+// 二元运算（先按64位计算，除数为0时结果为0）
+int applyOp(Op op, int a, int b) {
+    const long long x = a, y = b;
+    switch (op) {
+        case Op::ADD: return static_cast<int>(x + y);
+        case Op::SUB: return static_cast<int>(x - y);
+        case Op::MUL: return static_cast<int>(x * y);
+        case Op::DIV: return y != 0 ? static_cast<int>(x / y) : 0;
+        case Op::MOD: return y != 0 ? static_cast<int>(x % y) : 0;
+        case Op::EQ:  return a == b;
+        case Op::NE:  return a != b;
+        case Op::GT:  return a > b;
+        case Op::LT:  return a < b;
+        case Op::GE:  return a >= b;
+        case Op::LE:  return a <= b;
+        default:      return 0;
+    }
 }
 
-string ConditionEvaluator::replaceVariables(GameEngine& engine, const string& expr) {
-    regex varRegex("\\{([^}]+)\\}");
-    smatch match;
-    string result = expr;
-    
-    while(regex_search(result, match, varRegex)) {
-        string varName = match[1];
-        auto& variables = engine.getVariables();
-        int value = variables.count(varName) ? variables[varName] : 0;
-        result.replace(match.position(), match.length(), to_string(value));
-    }
-    return result;
+// 完整的十进制整数（可带符号）
+bool parseInt(string_view text, int& out) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < text.size() && (text[i] == '+' || text[i] == '-')) negative = text[i++] == '-';
+    if (i == text.size()) return false;
+    long long value = 0;
+    for (; i < text.size(); ++i) {
+        if (!isdigit(static_cast<unsigned char>(text[i]))) return false;
+        value = value * 10 + (text[i] - '0');
+        if (value > INT_MAX) return false;
+    }
+    out = static_cast<int>(negative ? -value : value);
+    return true;
 }
 
-bool ConditionEvaluator::evaluate(GameEngine& engine, const string& condition) {
-    vector<string> parts = tokenize(condition);
+/**
+ * @class TreeBuilder
+ * @brief 向语法树追加节点，常量子树在追加时折叠
+ */
+class TreeBuilder {
+public:
+    explicit TreeBuilder(CompiledCondition& tree) : tree(tree) {}
+
+    uint32_t constant(int value) {
+        Node node;
+        node.value = value;
+        return add(node);
+    }
+
+    // 变量或实体计分项（预先拆分"实体名.计分项"）
+    uint32_t value(string name) {
+        CompiledCondition::ValueRef ref;
+        size_t dot = name.rfind('.');
+        if (dot != string::npos && dot > 0 && dot + 1 < name.size()) {
+            ref.entity = name.substr(0, dot);
+            ref.objective = name.substr(dot + 1);
+        }
+        ref.name = std::move(name);
+        tree.values.push_back(std::move(ref));
+        return reference(Op::VALUE, tree.values.size() - 1);
+    }
+
+    // 比较的左侧：整数常量或名称
+    uint32_t operand(string text) {
+        int literal = 0;
+        return parseInt(text, literal) ? constant(literal) : value(std::move(text));
+    }
+
+    uint32_t named(Op op, string name) {
+        tree.names.push_back(std::move(name));
+        return reference(op, tree.names.size() - 1);
+    }
+
+    uint32_t predicate(vector<string> parts) {
+        tree.predicates.push_back(std::move(parts));
+        return reference(Op::PREDICATE, tree.predicates.size() - 1);
+    }
+
+    uint32_t unary(Op op, uint32_t child) {
+        if (isConstant(child)) {
+            const int value = tree.nodes[child].value;
+            return constant(op == Op::NOT ? !value : static_cast<int>(-static_cast<long long>(value)));
+        }
+        Node node;
+        node.op = op;
+        node.left = child;
+        return add(node);
+    }
+
+    uint32_t binary(Op op, uint32_t left, uint32_t right) {
+        if (isConstant(left) && isConstant(right)) {
+            const int a = tree.nodes[left].value, b = tree.nodes[right].value;
+            if (op == Op::AND) return constant(a && b);
+            if (op == Op::OR) return constant(a || b);
+            return constant(applyOp(op, a, b));
+        }
+        if (op == Op::AND || op == Op::OR) {
+            // 左侧为常量时短路已确定；右侧为常量且左侧无副作用时同样可以化简
+            const bool absorbing = op == Op::OR; // or遇真、and遇假即确定结果
+            if (isConstant(left)) return (tree.nodes[left].value != 0) == absorbing ? constant(absorbing) : right;
+            if (isConstant(right)) {
+                if ((tree.nodes[right].value != 0) != absorbing) return left;
+                if (isPure(left)) return constant(absorbing);
+            }
+        }
+        Node node;
+        node.op = op;
+        node.left = left;
+        node.right = right;
+        return add(node);
+    }
+
+private:
+    CompiledCondition& tree;
 
-    // 物品持有检查
-    if (!parts.empty() && parts[0] == "have" && parts.size() >= 2) {
-        auto& inventory = engine.getInventoryManager().getItems();
-        return any_of(inventory.begin(), inventory.end(), [&](const GameObject& item) {
-            return item.name == parts[1] && item.getProperty("count", 1) > 0; 
-        });
+    uint32_t add(const Node& node) {
+        tree.nodes.push_back(node);
+        return static_cast<uint32_t>(tree.nodes.size() - 1);
     }
 
-    // 地点标记检查
-    if (!parts.empty() && parts[0] == "去过" && parts.size() >= 2) {
-        auto& markers = engine.getVisitedMarkers();
-        return markers.find(parts[1]) != markers.end();
+    uint32_t reference(Op op, size_t ref) {
+        Node node;
+        node.op = op;
+        node.ref = static_cast<uint32_t>(ref);
+        return add(node);
     }
 
-    // 变量比较
-    if (parts.size() == 3 && parts[1] == "is") {
-        auto& variables = engine.getVariables();
-        int lhs = variables.count(parts[0]) ? variables[parts[0]] : 0;
-        int rhs = evaluateExpression(engine, parts[2]);
-        return lhs == rhs;
+    bool isConstant(uint32_t node) const { return tree.nodes[node].op == Op::CONST; }
+
+    // 子树中没有插件谓词（求值无副作用，可以不求值）
+    bool isPure(uint32_t index) const {
+        const Node& node = tree.nodes[index];
+        switch (node.op) {
+            case Op::PREDICATE: return false;
+            case Op::CONST: case Op::VALUE: case Op::HAVE: case Op::VISITED: return true;
+            case Op::NOT: case Op::NEG: return isPure(node.left);
+            default: return isPure(node.left) && isPure(node.right);
+        }
     }
+};
 
-    // 通用比较运算符
-    string condNoSpace = condition;
-    condNoSpace.erase(
-        remove_if(condNoSpace.begin(), condNoSpace.end(), ::isspace),
-        condNoSpace.end()
-    );
+/**
+ * @class ExpressionParser
+ * @brief 算术表达式的递归下降解析
+ *
+ * 表达式 := 项 (('+'|'-') 项)*
+ * 项     := 因子 (('*'|'/'|'%') 因子)*
+ * 因子   := ('+'|'-') 因子 | '(' 表达式 ')' | 整数 | '{' 名称 '}'
+ */
+class ExpressionParser {
+public:
+    ExpressionParser(string_view text, TreeBuilder& builder) : text(text), builder(builder) {}
 
-    regex compRegex(R"(^(\w+)(==|!=|>=|<=|>|<)(.+)$)");
-    smatch match;
-    if (regex_match(condNoSpace, match, compRegex)) {
-        string varName = match[1];
-        string op = match[2];
-        string rhsExpr = match[3];
+    // 解析整个文本，失败时返回false
+    bool parse(uint32_t& root) {
+        if (!additive(root)) return false;
+        skipSpaces();
+        return pos == text.size();
+    }
 
-        auto& variables = engine.getVariables();
-        int lhs = variables.count(varName) ? variables[varName] : 0;
-        int rhs = evaluateExpression(engine, rhsExpr);
+private:
+    string_view text;
+    TreeBuilder& builder;
+    size_t pos = 0;
 
-        if (op == "==") return lhs == rhs;
-        if (op == "!=") return lhs != rhs;
-        if (op == ">=") return lhs >= rhs;
-        if (op == "<=") return lhs <= rhs;
-        if (op == ">")  return lhs > rhs;
-        if (op == "<")  return lhs < rhs;
+    void skipSpaces() {
+        while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos]))) ++pos;
     }
 
-    throw runtime_error("无效条件格式: " + condition);
+    bool accept(char c) {
+        skipSpaces();
+        if (pos < text.size() && text[pos] == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool additive(uint32_t& node) {
+        if (!term(node)) return false;
+        while (true) {
+            Op op;
+            if (accept('+')) op = Op::ADD;
+            else if (accept('-')) op = Op::SUB;
+            else return true;
+            uint32_t right;
+            if (!term(right)) return false;
+            node = builder.binary(op, node, right);
+        }
+    }
+
+    bool term(uint32_t& node) {
+        if (!factor(node)) return false;
+        while (true) {
+            Op op;
+            if (accept('*')) op = Op::MUL;
+            else if (accept('/')) op = Op::DIV;
+            else if (accept('%')) op = Op::MOD;
+            else return true;
+            uint32_t right;
+            if (!factor(right)) return false;
+            node = builder.binary(op, node, right);
+        }
+    }
+
+    bool factor(uint32_t& node) {
+        if (accept('-')) {
+            if (!factor(node)) return false;
+            node = builder.unary(Op::NEG, node);
+            return true;
+        }
+        if (accept('+')) return factor(node);
+        if (accept('(')) return additive(node) && accept(')');
+        if (accept('{')) {
+            const size_t close = text.find('}', pos);
+            if (close == string_view::npos || close == pos) return false;
+            node = builder.value(string(text.substr(pos, close - pos)));
+            pos = close + 1;
+            return true;
+        }
+        const size_t start = pos;
+        while (pos < text.size() && isdigit(static_cast<unsigned char>(text[pos]))) ++pos;
+        int value = 0;
+        if (!parseInt(text.substr(start, pos - start), value)) return false;
+        node = builder.constant(value);
+        return true;
+    }
+};
+
+// 编译表达式，格式无效时为常量0（与求值失败的结果一致）
+uint32_t compileExpressionInto(string_view text, TreeBuilder& builder) {
+    uint32_t root = 0;
+    ExpressionParser parser(text, builder);
+    return parser.parse(root) ? root : builder.constant(0);
 }
 
-int ConditionEvaluator::evaluateExpression(GameEngine& engine, const string& expr) {
-    try {
-        string processed = replaceVariables(engine, expr);
-        processed = regex_replace(processed, regex("\\s*([+\\-*/])\\s*"), "$1");
-        
-        // 纯数字直接返回
-        try {
-            size_t pos;
-            int result = stoi(processed, &pos);
-            if(pos == processed.size()) return result;
-        } catch(...) {}
-        
-        // 简单二元运算
-        regex opRegex(R"((\d+)([+*/-])(\d+))");
-        smatch match;
-        if(regex_match(processed, match, opRegex)) {
-            int a = stoi(match[1]);
-            int b = stoi(match[3]);
-            char op = match[2].str()[0];
-            switch(op) {
-                case '+': return a + b;
-                case '-': return a - b;
-                case '*': return a * b;
-                case '/': return b != 0 ? a / b : 0;
+/**
+ * @struct Token
+ * @brief 条件的词法单元：词或括号
+ */
+struct Token {
+    enum class Kind { WORD, OPEN, CLOSE } kind;
+    string text;
+    bool quoted = false; ///< 带引号的词不作为关键字
+};
+
+// 按空白和括号切分（双引号内原样保留，支持 \" \\ \n \t 转义）
+vector<Token> tokenize(const string& condition) {
+    vector<Token> tokens;
+    size_t i = 0;
+    while (i < condition.size()) {
+        const char c = condition[i];
+        if (isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        } else if (c == '(' || c == ')') {
+            tokens.push_back({c == '(' ? Token::Kind::OPEN : Token::Kind::CLOSE, string(1, c)});
+            ++i;
+        } else if (c == '"') {
+            Token token{Token::Kind::WORD, "", true};
+            for (++i; i < condition.size() && condition[i] != '"'; ++i) {
+                if (condition[i] == '\\' && i + 1 < condition.size()) {
+                    const char next = condition[++i];
+                    token.text += next == 'n' ? '\n' : next == 't' ? '\t' : next;
+                } else {
+                    token.text += condition[i];
+                }
+            }
+            ++i; // 跳过右引号
+            tokens.push_back(std::move(token));
+        } else {
+            const size_t start = i;
+            while (i < condition.size() && !isspace(static_cast<unsigned char>(condition[i])) &&
+                   condition[i] != '(' && condition[i] != ')' && condition[i] != '"') {
+                ++i;
+            }
+            tokens.push_back({Token::Kind::WORD, condition.substr(start, i - start)});
+        }
+    }
+    return tokens;
+}
+
+/**
+ * @class ConditionParser
+ * @brief 条件的递归下降解析
+ *
+ * 或     := 与 ('or' 与)*
+ * 与     := 非 ('and' 非)*
+ * 非     := 'not' 非 | '(' 或 ')' | 基本条件
+ * 基本条件为到下一个and/or或右括号为止的各词，其中的括号按算术括号处理（如 "gold==(1+2)*3"）
+ */
+class ConditionParser {
+public:
+    ConditionParser(vector<Token> tokens, TreeBuilder& builder) : tokens(std::move(tokens)), builder(builder) {}
+
+    bool parse(uint32_t& root) { return disjunction(root) && pos == tokens.size(); }
+
+private:
+    vector<Token> tokens;
+    TreeBuilder& builder;
+    size_t pos = 0;
+
+    bool keyword(const char* word) const {
+        return pos < tokens.size() && tokens[pos].kind == Token::Kind::WORD && !tokens[pos].quoted &&
+               tokens[pos].text == word;
+    }
+
+    bool disjunction(uint32_t& node) {
+        if (!conjunction(node)) return false;
+        while (keyword("or")) {
+            ++pos;
+            uint32_t right;
+            if (!conjunction(right)) return false;
+            node = builder.binary(Op::OR, node, right);
+        }
+        return true;
+    }
+
+    bool conjunction(uint32_t& node) {
+        if (!negation(node)) return false;
+        while (keyword("and")) {
+            ++pos;
+            uint32_t right;
+            if (!negation(right)) return false;
+            node = builder.binary(Op::AND, node, right);
+        }
+        return true;
+    }
+
+    bool negation(uint32_t& node) {
+        if (keyword("not")) {
+            ++pos;
+            if (!negation(node)) return false;
+            node = builder.unary(Op::NOT, node);
+            return true;
+        }
+        if (pos < tokens.size() && tokens[pos].kind == Token::Kind::OPEN) {
+            ++pos;
+            if (!disjunction(node) || pos == tokens.size() || tokens[pos].kind != Token::Kind::CLOSE) return false;
+            ++pos;
+            return true;
+        }
+        return leaf(node);
+    }
+
+    bool leaf(uint32_t& node) {
+        vector<string> words;
+        while (pos < tokens.size() && !keyword("and") && !keyword("or")) {
+            const Token& token = tokens[pos];
+            if (token.kind == Token::Kind::CLOSE) break;
+            if (token.kind == Token::Kind::OPEN) {
+                if (words.empty()) return false;
+                // 算术括号：整组并入当前条件
+                int depth = 0;
+                do {
+                    if (tokens[pos].kind == Token::Kind::OPEN) ++depth;
+                    else if (tokens[pos].kind == Token::Kind::CLOSE) --depth;
+                    words.push_back(tokens[pos++].text);
+                } while (depth > 0 && pos < tokens.size());
+                if (depth > 0) return false;
+                continue;
             }
+            words.push_back(token.text);
+            ++pos;
+        }
+        return !words.empty() && basic(std::move(words), node);
+    }
+
+    // 基本条件（按原有优先级：物品、地点、插件谓词、is比较、比较运算符）
+    bool basic(vector<string> words, uint32_t& node) {
+        if (words.size() >= 2 && words[0] == "have") {
+            node = builder.named(Op::HAVE, std::move(words[1]));
+            return true;
+        }
+        if (words.size() >= 2 && words[0] == "去过") {
+            node = builder.named(Op::VISITED, std::move(words[1]));
+            return true;
+        }
+        if (PluginHost::getInstance().hasPredicate(words[0])) {
+            node = builder.predicate(std::move(words));
+            return true;
+        }
+
+        string rhs;
+        if (words.size() >= 3 && words[1] == "is") {
+            for (size_t i = 2; i < words.size(); ++i) rhs += words[i];
+            const uint32_t lhs = builder.operand(std::move(words[0]));
+            node = builder.binary(Op::EQ, lhs, compileExpressionInto(rhs, builder));
+            return true;
+        }
+
+        // 比较运算符：忽略空白，左侧为名称，右侧为表达式
+        string joined;
+        for (const auto& word : words) joined += word;
+        const size_t at = joined.find_first_of("=!<>");
+        if (at == string::npos || at == 0) return false;
+        static const pair<const char*, Op> OPERATORS[] = {
+            {"==", Op::EQ}, {"!=", Op::NE}, {">=", Op::GE}, {"<=", Op::LE}, {">", Op::GT}, {"<", Op::LT},
+        };
+        for (const auto& [text, op] : OPERATORS) {
+            const size_t length = char_traits<char>::length(text);
+            if (joined.compare(at, length, text) != 0) continue;
+            rhs = joined.substr(at + length);
+            if (rhs.empty()) return false;
+            const uint32_t lhs = builder.operand(joined.substr(0, at));
+            node = builder.binary(op, lhs, compileExpressionInto(rhs, builder));
+            return true;
+        }
+        return false;
+    }
+};
+}
+
+CompiledCondition ConditionEvaluator::compile(const string& condition) {
+    CompiledCondition tree;
+    tree.source = condition;
+    TreeBuilder builder(tree);
+    ConditionParser parser(tokenize(condition), builder);
+    tree.valid = parser.parse(tree.root);
+    return tree;
+}
+
+CompiledCondition ConditionEvaluator::compileExpression(const string& expr) {
+    CompiledCondition tree;
+    tree.source = expr;
+    TreeBuilder builder(tree);
+    ExpressionParser parser(expr, builder);
+    tree.valid = parser.parse(tree.root);
+    return tree;
+}
+
+void ConditionEvaluator::clearCache() {
+    conditionCache.clear();
+    expressionCache.clear();
+}
+
+int ConditionEvaluator::lookupValue(GameEngine& engine, const CompiledCondition::ValueRef& ref) {
+    // 实体计分项：实体名.计分项
+    if (!ref.objective.empty() && engine.scoreboard.hasObjective(ref.objective)) {
+        // 只查已构建的地图：未构建地图上的实体还没有计分，取默认值（ID 0）
+        if (GameObject* entity = engine.findBuiltEntity(ref.entity)) {
+            return engine.scoreboard.get(ref.objective, entity->entityId);
+        }
+        return engine.hasPendingEntity(ref.entity) ? engine.scoreboard.get(ref.objective, 0) : 0;
+    }
+    auto& variables = engine.getVariables();
+    auto it = variables.find(ref.name);
+    return it != variables.end() ? it->second : 0;
+}
+
+int ConditionEvaluator::evaluateNode(GameEngine& engine, const CompiledCondition& tree, uint32_t index) {
+    const Node& node = tree.nodes[index];
+    switch (node.op) {
+        case Op::CONST:
+            return node.value;
+        case Op::VALUE:
+            return lookupValue(engine, tree.values[node.ref]);
+        case Op::HAVE: {
+            const string& name = tree.names[node.ref];
+            auto& inventory = engine.getInventoryManager().getItems();
+            return any_of(inventory.begin(), inventory.end(), [&](const GameObject& item) {
+                return item.name == name && item.getProperty("count", 1) > 0;
+            });
+        }
+        case Op::VISITED:
+            return engine.getVisitedMarkers().count(tree.names[node.ref]) > 0;
+        case Op::PREDICATE: {
+            optional<bool> result = PluginHost::getInstance().evaluatePredicate(engine, tree.predicates[node.ref]);
+            if (!result) throw runtime_error("无效条件格式: " + tree.source);
+            return *result;
         }
-        return 0;
-    } catch (const exception& e) {
-        Log log("error.log");
-        log.error("表达式解析错误: ", string(e.what()));
-        return 0;
+        case Op::NOT:
+            return !evaluateNode(engine, tree, node.left);
+        case Op::AND:
+            return evaluateNode(engine, tree, node.left) && evaluateNode(engine, tree, node.right);
+        case Op::OR:
+            return evaluateNode(engine, tree, node.left) || evaluateNode(engine, tree, node.right);
+        case Op::NEG:
+            return static_cast<int>(-static_cast<long long>(evaluateNode(engine, tree, node.left)));
+        default:
+            return applyOp(node.op, evaluateNode(engine, tree, node.left), evaluateNode(engine, tree, node.right));
     }
-}
\ No newline at end of file
+}
+
+bool ConditionEvaluator::evaluate(GameEngine& engine, const CompiledCondition& condition) {
+    if (!condition.valid) throw runtime_error("无效条件格式: " + condition.source);
+    return evaluateNode(engine, condition, condition.root) != 0;
+}
+
+bool ConditionEvaluator::evaluate(GameEngine& engine, const string& condition) {
+    // 查找编译缓存，未命中时编译一次（缓存已满则不再缓存新条件）
+    auto it = conditionCache.find(condition);
+    if (it == conditionCache.end()) {
+        if (conditionCache.size() >= MAX_CACHED) return evaluate(engine, compile(condition));
+        it = conditionCache.emplace(condition, compile(condition)).first;
+    }
+    return evaluate(engine, it->second);
+}
+
+int ConditionEvaluator::evaluateExpression(GameEngine& engine, const string& expr) {
+    auto it = expressionCache.find(expr);
+    if (it == expressionCache.end()) {
+        if (expressionCache.size() >= MAX_CACHED) {
+            const CompiledCondition tree = compileExpression(expr);
+            return tree.valid ? evaluateNode(engine, tree, tree.root) : 0;
+        }
+        it = expressionCache.emplace(expr, compileExpression(expr)).first;
+    }
+    const CompiledCondition& tree = it->second;
+    return tree.valid ? evaluateNode(engine, tree, tree.root) : 0;
+}
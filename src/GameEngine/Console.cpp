@@ -0,0 +1,198 @@
+// src/GameEngine/Console.cpp
+#include "Console.h"
+#include "CommandParser.h"
+#include "GameEngine.h"
+#include "ScriptLexer.h"
+#include <algorithm>
+#include <exception>
+#include <string_view>
+
+namespace {
+constexpr std::size_t MAX_LISTED = 32;      ///< 一次最多列出的候选数
+constexpr std::size_t LIST_WIDTH = 72;      ///< 候选列表每行的宽度（字节）
+constexpr std::size_t MAX_POSITIONS = 5;    ///< 查看实体时每张地图最多显示的同名对象数
+
+// 当前正在输入的词的起始位置
+std::size_t wordStart(const std::string& line) {
+    std::size_t pos = line.find_last_of(" \t");
+    return pos == std::string::npos ? 0 : pos + 1;
+}
+
+// 有序表中以prefix开头的键（二分查找定位后顺序取）
+template<typename Map>
+void addKeys(const Map& map, std::string_view prefix, std::vector<std::string>& out) {
+    std::size_t taken = 0;
+    for (auto it = map.lower_bound(std::string(prefix)); it != map.end() && taken < Console::MAX_CANDIDATES; ++it, ++taken) {
+        if (it->first.compare(0, prefix.size(), prefix) != 0) break;
+        out.push_back(it->first);
+    }
+}
+}
+
+void Console::backspace() {
+    // UTF-8续字节（10xxxxxx）与首字节一起删除
+    while (!input.empty() && (static_cast<unsigned char>(input.back()) & 0xC0) == 0x80) input.pop_back();
+    if (!input.empty()) input.pop_back();
+}
+
+void Console::print(std::string line) {
+    output.push_back(std::move(line));
+    if (output.size() > MAX_OUTPUT_LINES) output.pop_front();
+}
+
+void Console::historyPrev() {
+    if (historyIndex == 0) return;
+    input = history[--historyIndex];
+}
+
+void Console::historyNext() {
+    if (historyIndex >= history.size()) return;
+    ++historyIndex;
+    input = historyIndex < history.size() ? history[historyIndex] : std::string();
+}
+
+void Console::submit(GameEngine& engine) {
+    const std::size_t first = input.find_first_not_of(" \t");
+    if (first == std::string::npos) {
+        input.clear();
+        return;
+    }
+    const std::string line = input.substr(first, input.find_last_not_of(" \t") - first + 1);
+    input.clear();
+    if (history.empty() || history.back() != line) history.push_back(line);
+    if (history.size() > MAX_HISTORY) history.erase(history.begin());
+    historyIndex = history.size();
+
+    print("> " + line);
+    if (line[0] != '/') {
+        inspect(engine, line);
+        return;
+    }
+
+    std::vector<std::string> errors;
+    try {
+        CommandParser::DiagnosticsCapture capture(errors);
+        engine.parseLine(line);
+    } catch (const std::exception& e) {
+        errors.push_back(e.what());
+    }
+    if (errors.empty()) print("完成");
+    for (const auto& error : errors) print("错误: " + error);
+}
+
+std::vector<std::string> Console::candidates(GameEngine& engine, const std::string& line) {
+    const std::size_t start = wordStart(line);
+    const std::string_view word = std::string_view(line).substr(start);
+    const std::vector<std::string> before = ScriptLexer::split(std::string_view(line).substr(0, start));
+
+    std::vector<std::string> out;
+    // 第一个词：命令名（查看状态时为名称）
+    if (before.empty() && (word.empty() || word[0] == '/')) return CommandParser::completeCommand(word);
+
+    // 第二个词：有子命令的命令补全子命令
+    if (before.size() == 1 && before[0][0] == '/') {
+        if (const CommandHandler* handler = CommandParser::findCommand(before[0])) {
+            const auto& table = handler->getSubcommands();
+            if (!table.complete("").empty()) return table.complete(word);
+        }
+    }
+
+    // 其余：地图、实体、变量等名称
+    addKeys(engine.maps, word, out);
+    addKeys(engine.pendingMaps, word, out);
+    for (const auto& [mapName, gameMap] : engine.maps) {
+        auto names = gameMap.completeName(word, MAX_CANDIDATES);
+        out.insert(out.end(), std::make_move_iterator(names.begin()), std::make_move_iterator(names.end()));
+    }
+    addKeys(engine.npcTemplates, word, out);
+    addKeys(engine.items, word, out);
+    addKeys(engine.variables, word, out);
+    addKeys(engine.scoreboard.getObjectives(), word, out);
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+void Console::complete(GameEngine& engine) {
+    const std::vector<std::string> list = candidates(engine, input);
+    if (list.empty()) return;
+    const std::size_t start = wordStart(input);
+    if (list.size() == 1) {
+        input.replace(start, std::string::npos, list[0] + " ");
+        return;
+    }
+
+    // 补全到公共前缀（不截断UTF-8字符）
+    std::size_t common = list[0].size();
+    for (const auto& candidate : list) {
+        std::size_t same = 0;
+        while (same < common && same < candidate.size() && candidate[same] == list[0][same]) ++same;
+        common = same;
+    }
+    while (common > 0 && common < list[0].size() && (static_cast<unsigned char>(list[0][common]) & 0xC0) == 0x80) --common;
+    if (common > input.size() - start) input.replace(start, std::string::npos, list[0].substr(0, common));
+
+    // 列出候选
+    std::string row;
+    for (std::size_t i = 0; i < list.size() && i < MAX_LISTED; ++i) {
+        if (!row.empty() && row.size() + list[i].size() > LIST_WIDTH) {
+            print(row);
+            row.clear();
+        }
+        row += list[i] + "  ";
+    }
+    if (list.size() > MAX_LISTED) row += "...（共" + std::to_string(list.size()) + "个）";
+    print(row);
+}
+
+void Console::inspect(GameEngine& engine, const std::string& name) {
+    bool found = false;
+    if (auto it = engine.variables.find(name); it != engine.variables.end()) {
+        print("变量 " + name + " = " + std::to_string(it->second));
+        found = true;
+    }
+    const auto& objectives = engine.scoreboard.getObjectives();
+    if (auto it = objectives.find(name); it != objectives.end()) {
+        print("计分项 " + name + "（默认值 " + std::to_string(it->second.defaultValue) + "）");
+        found = true;
+    }
+    if (auto it = engine.npcTemplates.find(name); it != engine.npcTemplates.end()) {
+        print("NPC " + name + ": " + it->second.getFormattedProperties());
+        found = true;
+    }
+    if (auto it = engine.items.find(name); it != engine.items.end()) {
+        print("物品 " + name + ": " + it->second.getFormattedProperties());
+        found = true;
+    }
+    if (auto it = engine.maps.find(name); it != engine.maps.end() && !engine.pendingMaps.count(name)) {
+        const GameMap& gameMap = it->second;
+        print("地图 " + name + ": " + std::to_string(gameMap.getWidth()) + "x" + std::to_string(gameMap.getHeight()) +
+              "，" + std::to_string(gameMap.getAllObjects().size()) + "个对象");
+        found = true;
+    } else if (engine.pendingMaps.count(name)) {
+        print("地图 " + name + ": 尚未构建");
+        found = true;
+    }
+
+    // 已构建地图上的同名实体，附带计分项
+    for (const auto& [mapName, gameMap] : engine.maps) {
+        const GameMap::PositionSet* positions = gameMap.positionsByName(name);
+        if (!positions) continue;
+        std::size_t shown = 0;
+        for (const auto& [x, y] : *positions) {
+            if (shown++ == MAX_POSITIONS) {
+                print("  ...（共" + std::to_string(positions->size()) + "个）");
+                break;
+            }
+            const GameObject& obj = gameMap.getAllObjects().at({x, y});
+            std::string line = "实体 " + name + ": " + obj.type + " @" + mapName + " (" + std::to_string(x) + "," +
+                               std::to_string(y) + ")，属性 " + obj.getFormattedProperties();
+            for (const auto& [objective, column] : objectives) {
+                line += "，" + objective + "=" + std::to_string(engine.scoreboard.get(objective, obj.entityId));
+            }
+            print(std::move(line));
+        }
+        found = true;
+    }
+    if (!found) print("未找到: " + name);
+}
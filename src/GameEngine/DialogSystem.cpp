@@ -2,6 +2,7 @@
 #include "DialogSystem.h"
 #include "GameEngine.h"
 #include "Log.h"
+#include "PluginHost.h"
 #include <ncurses.h>
 #include <vector>
 #include <sstream>
@@ -65,9 +66,7 @@ void DialogSystem::handleInput(GameEngine& engine, int key) {
     if (key == '\n') {
         // 触发后续命令逻辑
         if (currentDialog->lines.size() > 1) {
-            string selected = currentDialog->lines[currentDialog->selectedOption];
-            vector<string> tokens = engine.tokenize(selected);
-            engine.runCommand(tokens);
+            engine.parseLine(currentDialog->lines[currentDialog->selectedOption]);
         }
         closeDialog(engine);
     }
@@ -85,17 +84,18 @@ void DialogSystem::tryTalkToNPC(GameEngine& engine) {
         );
         
         if (obj.isType("npc") && !obj.dialogues.empty()) {
+            PluginHost::getInstance().dispatch(engine, GAME_PLUGIN_EVENT_NPC_TALK, obj.name);
             // 检查条件对话
             for (const auto& [cond, dialog] : obj.dialogues) {
                 if (cond != "default" && engine.evalCondition(cond)) {
-                    showDialog({engine.tokenize(dialog), obj.name}, engine);
+                    showDialog({{dialog}, obj.name}, engine);
                     return;
                 }
             }
             
             // 默认对话
             if (obj.dialogues.count("default")) {
-                showDialog({engine.tokenize(obj.dialogues.at("default")), obj.name}, engine);
+                showDialog({{obj.dialogues.at("default")}, obj.name}, engine);
                 return;
             }
         }
@@ -1,37 +1,436 @@
 // File: src/GameEngine/GameEngine.cpp
 #include "GameEngine.h"
 #include "Commands/CommandParser.h"
+#include "CommandAccess.h"
+#include "ConcreteCommands/MapCommand.h"
+#include "CommandUtils.h"
+#include "LoadProfiler.h"
 #include "Log.h"
+#include "MappedFile.h"
+#include "PluginHost.h"
+#include "ScriptLexer.h"
+#include "WorldSnapshot.h"
+#include <atomic>
 #include <fstream>
 #include <sstream>
 #include <regex>
-#include <ncurses.h>
+#include <thread>
 
-GameEngine::GameEngine() : renderer(std::make_unique<Renderer>()), inputHandler(*this) {}
+namespace {
+constexpr size_t PARALLEL_MIN_COMMANDS = 256; ///< 少于该数量的init块直接顺序执行
 
-// 核心游戏循环
-void GameEngine::startGameLoop() {
-    renderer->initScreen();
-    while(true) {
-        renderer->render(*this);
-        int ch = getch();
-        inputHandler.processInput(ch);
+// 在工作线程上按下标领取任务；主线程先执行mainFirst，再参与领取剩余任务
+template<typename Task, typename MainTask>
+void runWorkers(size_t taskCount, Task task, MainTask mainFirst) {
+    std::atomic<size_t> nextTask{0};
+    auto worker = [&]() {
+        for (size_t i = nextTask++; i < taskCount; i = nextTask++) task(i);
+    };
+    size_t workerCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), taskCount);
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < workerCount; ++i) workers.emplace_back(worker);
+    mainFirst();
+    worker();
+    for (auto& t : workers) t.join();
+}
+
+// 记录的构建命令中是否放置了该名称的对象
+bool placesEntity(const PendingMapProgram& program, const std::string& name) {
+    for (const auto& pending : program) {
+        auto placement = MapCommand::parsePlacement(pending.command.args);
+        if (placement && placement->params.get("name") == name) return true;
+    }
+    return false;
+}
+
+// setblock/fill命令的目标地图（其他命令或含选择器时为nullptr）
+const std::string* placementTarget(const CompiledCommand& command) {
+    if (!command.subcommand || command.hasSelector || command.args.size() < 3 || command.args[0] != "/map") {
+        return nullptr;
+    }
+    const std::string& sub = command.args[1];
+    return sub == "setblock" || sub == "fill" ? &command.args[2] : nullptr;
+}
+}
+
+GameEngine::GameEngine() {}
+
+// 脚本热重载
+void GameEngine::enableHotReload() {
+    if (loadedScript.getBlocks().empty()) {
+        MappedFile source(scriptFile);
+        loadedScript = Script::compile(source.view());
+    }
+    scriptWatcher = std::make_unique<ScriptWatcher>(scriptFile);
+}
+
+void GameEngine::reloadScript() {
+    Script updated;
+    try {
+        MappedFile source(scriptFile);
+        updated = Script::compile(source.view());
+    } catch (const std::exception& e) {
+        Log log("error.log");
+        log.error("脚本重新加载失败: ", std::string(e.what()));
+        return;
+    }
+
+    // 块标识：类型 + 声明 + 同标识块的出现次序
+    auto keyOf = [](const ScriptBlock& block, std::map<std::string, int>& seen) {
+        std::string key = std::to_string(static_cast<int>(block.kind)) + ":" + block.header;
+        return key + "#" + std::to_string(seen[key]++);
+    };
+
+    std::map<std::string, const ScriptBlock*> previous;
+    std::map<std::string, int> seen;
+    for (const auto& block : loadedScript.getBlocks()) previous[keyOf(block, seen)] = &block;
+
+    // 整次重载作为一个事务：任一命令失败时恢复到重载前的状态，继续以旧脚本为基准
+    bool committed = false;
+    try {
+        committed = runTransaction([&]() {
+            runBatched([&]() {
+                seen.clear();
+                for (const auto& block : updated.getBlocks()) {
+                    auto it = previous.find(keyOf(block, seen));
+                    const ScriptBlock* old = nullptr;
+                    if (it != previous.end()) {
+                        old = it->second;
+                        previous.erase(it);
+                    }
+                    applyBlockChange(old, &block);
+                }
+                for (const auto& [key, block] : previous) applyBlockChange(block, nullptr);
+            });
+        });
+    } catch (const std::exception& e) {
+        Log log("error.log");
+        log.error("脚本重新加载失败: ", std::string(e.what()));
+        return;
+    }
+    if (!committed) {
+        Log log("error.log");
+        log.error("脚本重新加载时有命令执行失败，已撤销本次修改");
+        return;
+    }
+
+    loadedScript = std::move(updated);
+#ifdef DEBUG
+    Log log("debug.log");
+    log.debug("脚本已重新加载: ", scriptFile);
+#endif
+}
+
+void GameEngine::applyBlockChange(const ScriptBlock* previous, const ScriptBlock* current) {
+    if (previous && current && previous->lines == current->lines) return;
+    const ScriptBlock& block = current ? *current : *previous;
+
+    // 物品效果块整体替换
+    if (block.kind == ScriptBlock::Kind::ITEM_EFFECT) {
+        if (journal) journal->recordItem(block.header);
+        itemEffects.erase(block.header);
+        auto item = items.find(block.header);
+        if (item != items.end()) item->second.useEffects.clear();
+        if (current && items.count(current->header)) addItemEffects(current->header, current->lines, current->commands);
+        return;
+    }
+
+    // 逐行求差（按出现次数），只处理删除和新增的行
+    std::multiset<std::string> remaining;
+    if (current) remaining.insert(current->lines.begin(), current->lines.end());
+    if (previous) {
+        for (size_t i = 0; i < previous->lines.size(); ++i) {
+            auto it = remaining.find(previous->lines[i]);
+            if (it != remaining.end()) remaining.erase(it);
+            else clearMapCommand(previous->commands[i].args);
+        }
+    }
+    if (!current) return;
+    if (current->kind == ScriptBlock::Kind::IF && !ConditionEvaluator::evaluate(*this, current->header)) return;
+
+    std::multiset<std::string> existing;
+    if (previous) existing.insert(previous->lines.begin(), previous->lines.end());
+    for (size_t i = 0; i < current->lines.size(); ++i) {
+        auto it = existing.find(current->lines[i]);
+        if (it != existing.end()) existing.erase(it);
+        else CommandParser::execute(current->commands[i], *this);
+    }
+}
+
+void GameEngine::clearMapCommand(const std::vector<std::string>& args) {
+    if (args.size() < 3 || args[0] != "/map" || !hasMap(args[2])) return;
+    if (args[1] != "setblock" && args[1] != "fill") return;
+    // 原命令本身无效时没有放置过对象
+    const auto placement = MapCommand::parsePlacement(args);
+    if (!placement) return;
+    const auto [x1, y1, x2, y2] = std::make_tuple(placement->x1, placement->y1, placement->x2, placement->y2);
+    if (journal) journal->recordArea(placement->map, x1, y1, x2, y2);
+
+    GameMap& gameMap = getMap(placement->map);
+    for (int x = std::min(x1, x2); x <= std::max(x1, x2); ++x) {
+        for (int y = std::min(y1, y2); y <= std::max(y1, y2); ++y) {
+            gameMap.removeObject(x, y);
+        }
     }
 }
 
 // 命令执行入口
 void GameEngine::runCommand(const std::vector<std::string>& tokens) {
-    std::string commandLine;
-    for (const auto& token : tokens) {
-        if (!commandLine.empty()) commandLine += " ";
-        commandLine += token;
+    runBatched([&]() { CommandParser::execute(CommandParser::compile(tokens), *this); });
+}
+
+void GameEngine::runProgram(const CommandProgram& program) {
+    runBatch(program.data(), program.size());
+}
+
+void GameEngine::tick() {
+    runBatched([&]() {
+        scheduler.advance([&](const CompiledCommand& command) { CommandParser::execute(command, *this); });
+        PluginHost::getInstance().dispatch(*this, GAME_PLUGIN_EVENT_TICK, std::string());
+    });
+}
+
+void GameEngine::runBatch(const CompiledCommand* commands, size_t count) {
+    runBatched([&]() {
+        size_t i = 0;
+        while (i < count) {
+            // 连续写同一地图的放置命令：地图只查找一次，直接写入
+            const std::string* mapName = placementTarget(commands[i]);
+            if (!mapName || isDeferredMap(*mapName)) {
+                CommandParser::execute(commands[i++], *this);
+                continue;
+            }
+
+            GameMap& gameMap = getMap(*mapName);
+            for (; i < count; ++i) {
+                const CompiledCommand& command = commands[i];
+                const std::string* target = placementTarget(command);
+                if (!target || *target != *mapName) break;
+                LoadProfiler::CommandScope profile(command);
+                if (journal) journal->record(command);
+                if (CommandStatus status = MapCommand::apply(gameMap, command.args, items); !status) {
+                    if (journal) journal->markFailed();
+                    CommandParser::report("命令执行失败: " + status.message);
+                }
+            }
+        }
+    });
+}
+
+template<typename Body>
+void GameEngine::runBatched(Body&& body) {
+    if (batchDepth++ > 0) {
+        // 并入外层批量
+        try {
+            body();
+        } catch (...) {
+            --batchDepth;
+            throw;
+        }
+        --batchDepth;
+        return;
+    }
+
+    const std::string mapBefore = currentMap;
+    const int xBefore = playerX, yBefore = playerY;
+    auto finish = [&]() {
+        batchDepth = 0;
+        // 地图可能已在批量中被撤销或替换，按名称查找
+        for (const auto& name : batchMaps) {
+            auto it = maps.find(name);
+            if (it != maps.end()) it->second.endBatch();
+        }
+        batchMaps.clear();
+        // 本批命令的错误一次写入error.log
+        CommandParser::flushDiagnostics();
+    };
+    try {
+        body();
+    } catch (...) {
+        finish();
+        throw;
+    }
+    finish();
+    if ((currentMap != mapBefore || playerX != xBefore || playerY != yBefore) && maps.count(currentMap)) {
+        updateViewport();
     }
-    CommandParser::parseAndExecute(commandLine, *this);
 }
 
 // 地图相关方法
 GameMap& GameEngine::getCurrentMap() { 
-    return maps[currentMap];
+    return getMap(currentMap);
+}
+
+GameMap& GameEngine::getMap(const std::string& name) {
+    GameMap& gameMap = resolveMap(name);
+    // 批量执行期间访问的地图推迟维护索引
+    if (batchDepth > 0 && !gameMap.isBatching()) {
+        gameMap.beginBatch();
+        batchMaps.push_back(name);
+    }
+    return gameMap;
+}
+
+GameMap& GameEngine::resolveMap(const std::string& name) {
+    auto pending = pendingMaps.find(name);
+    if (pending == pendingMaps.end()) return maps[name];
+
+    // 已在后台预构建时直接取结果
+    auto prefetched = prefetchedMaps.find(name);
+    if (prefetched != prefetchedMaps.end()) {
+        GameMap built = prefetched->second.get();
+        prefetchedMaps.erase(prefetched);
+        pendingMaps.erase(pending);
+        return maps.insert_or_assign(name, std::move(built)).first->second;
+    }
+
+    // 否则立即执行记录的构建命令（构建只是延迟求值，不计入事务）
+    PendingMapProgram program = std::move(pending->second);
+    pendingMaps.erase(pending);
+    return maps.insert_or_assign(name, buildDetachedMap(program)).first->second;
+}
+
+void GameEngine::clearMaps() {
+    // 预构建线程只操作独立的地图副本，等待其结束后丢弃即可
+    for (auto& [name, future] : prefetchedMaps) future.wait();
+    prefetchedMaps.clear();
+    pendingMaps.clear();
+    for (auto& [name, gameMap] : maps) gameMap.clear(); // 回收实体ID
+    maps.clear();
+}
+
+void GameEngine::loadAllMaps() {
+    // 已在后台预构建的地图直接取结果
+    while (!prefetchedMaps.empty()) {
+        std::string name = prefetchedMaps.begin()->first; // 构建后键会被移除，需先复制
+        getMap(name);
+    }
+    if (pendingMaps.empty()) return;
+
+    std::vector<std::pair<std::string, PendingMapProgram>> programs(
+        std::make_move_iterator(pendingMaps.begin()), std::make_move_iterator(pendingMaps.end()));
+    pendingMaps.clear();
+
+    std::vector<GameMap> built(programs.size());
+    runWorkers(programs.size(), [&](size_t i) { built[i] = buildDetachedMap(programs[i].second); }, [] {});
+    for (size_t i = 0; i < programs.size(); ++i) {
+        maps.insert_or_assign(programs[i].first, std::move(built[i]));
+    }
+}
+
+GameMap GameEngine::buildDetachedMap(const PendingMapProgram& program) {
+    GameMap map;
+    for (const auto& [command, items] : program) {
+        if (CommandStatus status = MapCommand::apply(map, command.args, items); !status) {
+            CommandParser::report("命令执行失败: " + status.message);
+        }
+    }
+    return map;
+}
+
+bool GameEngine::deferMapCommand(const std::vector<std::string>& args) {
+    if (!deferMapBuilding || args.size() < 3) return false;
+    const std::string& subcmd = args[1];
+    if (subcmd != "create" && subcmd != "setblock" && subcmd != "fill") return false;
+
+    const std::string& name = args[2];
+    if (!isDeferredMap(name)) return false;
+
+    // 放置物品时保存此刻的定义；物品未定义时立即执行，在当前行报告错误
+    std::map<std::string, GameObject> placed;
+    if (auto placement = MapCommand::parsePlacement(args); placement && placement->type == "item") {
+        const std::string itemName(placement->params.get("name"));
+        auto item = items.find(itemName);
+        if (item == items.end()) return false;
+        placed.emplace(itemName, item->second);
+    }
+    pendingMaps[name].push_back({CommandParser::compile(args), std::move(placed)});
+    return true;
+}
+
+bool GameEngine::isDeferredMap(const std::string& name) const {
+    // 主地图和已构建的地图直接执行
+    return deferMapBuilding && name != "main" && !(maps.count(name) && !pendingMaps.count(name));
+}
+
+void GameEngine::setCurrentMap(const std::string& map) {
+    getMap(map);
+    currentMap = map;
+    prefetchNeighbors();
+    PluginHost::getInstance().dispatch(*this, GAME_PLUGIN_EVENT_MAP_ENTER, map);
+}
+
+void GameEngine::prefetchNeighbors() {
+    if (pendingMaps.empty() || !maps.count(currentMap)) return;
+
+    std::set<std::string> neighbors;
+    auto addTeleportTarget = [&](const std::vector<std::string>& args) {
+        if (args.size() > 1 && args[0] == "/teleport") neighbors.insert(args[1]);
+    };
+
+    for (const auto& [pos, obj] : maps.at(currentMap).getAllObjects()) {
+        for (const auto& [key, value] : obj.properties) {
+            if (auto text = std::get_if<std::string>(&value); text && pendingMaps.count(*text)) neighbors.insert(*text);
+        }
+        auto npc = npcTemplates.find(obj.name);
+        if (obj.isType("npc") && npc != npcTemplates.end()) {
+            for (const auto& [condition, dialogue] : npc->second.dialogues) {
+                std::istringstream lines(dialogue);
+                std::string line;
+                while (std::getline(lines, line)) {
+                    // 只看前两个词，以视图比较，不拷贝整行的词
+                    ScriptLexer lexer(line);
+                    ScriptToken command, target;
+                    if (lexer.next(command) && command.plain && command.raw == "/teleport" && lexer.next(target)) {
+                        neighbors.insert(target.value());
+                    }
+                }
+            }
+        }
+    }
+    for (const auto& [itemName, program] : itemEffects) {
+        for (const auto& command : program) addTeleportTarget(command.args);
+    }
+
+    for (const auto& name : neighbors) {
+        auto pending = pendingMaps.find(name);
+        if (pending == pendingMaps.end() || prefetchedMaps.count(name)) continue;
+
+        // 后台线程只操作独立的地图对象和构建命令副本（含记录时的物品定义），不访问引擎状态
+        prefetchedMaps.emplace(name, std::async(std::launch::async,
+            [program = pending->second]() { return buildDetachedMap(program); }));
+    }
+}
+
+GameObject* GameEngine::findEntity(const std::string& name) {
+    if (GameObject* obj = findBuiltEntity(name)) return obj;
+    for (const auto& mapName : pendingMapsWithEntity(name)) {
+        if (GameObject* obj = getMap(mapName).findObjectByName(name)) return obj;
+    }
+    return nullptr;
+}
+
+GameObject* GameEngine::findBuiltEntity(const std::string& name) {
+    for (auto& [mapName, gameMap] : maps) {
+        if (pendingMaps.count(mapName)) continue;
+        if (GameObject* obj = gameMap.findObjectByName(name)) return obj;
+    }
+    return nullptr;
+}
+
+std::vector<std::string> GameEngine::pendingMapsWithEntity(const std::string& name) const {
+    std::vector<std::string> found;
+    for (const auto& [mapName, program] : pendingMaps) {
+        if (placesEntity(program, name)) found.push_back(mapName);
+    }
+    return found;
+}
+
+bool GameEngine::hasPendingEntity(const std::string& name) const {
+    for (const auto& [mapName, program] : pendingMaps) {
+        if (placesEntity(program, name)) return true;
+    }
+    return false;
 }
 
 GameObject GameEngine::getObjectAt(int x, int y) {
@@ -49,88 +448,117 @@ void GameEngine::updateViewport() {
 
 // 脚本解析核心
 void GameEngine::parseLine(const std::string& line) {
-    std::vector<std::string> tokens = tokenize(line);
-    if(!tokens.empty()) runCommand(tokens);
-}
-
-// 初始化块处理
-void GameEngine::processInitBlock(std::ifstream& fs, int& lineNumber) {
-    int blockDepth = 1;
-    std::string line;
-    while (blockDepth > 0 && getline(fs, line)) {
-        lineNumber++;
-        size_t commentPos = line.find("//");
-        if (commentPos != std::string::npos)
-            line = line.substr(0, commentPos);
-        
-        line.erase(0, line.find_first_not_of(" \t"));
-        line.erase(line.find_last_not_of(" \t") + 1);
-        if (line.empty()) continue;
+    runBatched([&]() { CommandParser::parseAndExecute(line, *this); });
+}
 
-        if (line == "{") blockDepth++;
-        else if (line == "}") blockDepth--;
-        else parseLine(line);
+// 脚本块执行
+void GameEngine::executeBlock(const ScriptBlock& block) {
+    switch (block.kind) {
+        case ScriptBlock::Kind::INIT:
+            runBatched([&]() { runConcurrent(block.commands); });
+            break;
+        case ScriptBlock::Kind::IF:
+            if (ConditionEvaluator::evaluate(*this, block.header)) runProgram(block.commands);
+            break;
+        case ScriptBlock::Kind::ITEM_EFFECT: {
+            if (items.find(block.header) == items.end()) throw std::runtime_error("Undefined item: " + block.header);
+            if (journal) journal->recordItem(block.header);
+            addItemEffects(block.header, block.lines, block.commands);
+            break;
+        }
     }
-    if (blockDepth != 0) throw std::runtime_error("Unclosed init block");
 }
 
-// 条件块处理
-void GameEngine::processIfBlock(std::ifstream& fs, const std::string& rawCondition, int currentLine) {
-    (void)currentLine;
-    std::string condition = rawCondition;
-    condition.erase(0, condition.find_first_not_of(" \t"));
-    condition.erase(condition.find_last_not_of(" \t") + 1);
-    
-    bool execute = ConditionEvaluator::evaluate(*this, condition);
-    int blockDepth = 1;
-    std::string line;
+template<typename Body>
+bool GameEngine::runTransaction(Body&& body) {
+    if (journal) {
+        body();
+        return true;
+    }
 
-    while (blockDepth > 0 && getline(fs, line)) {
-        size_t commentPos = line.find("//");
-        if (commentPos != std::string::npos)
-            line = line.substr(0, commentPos);
+    UndoJournal transaction(*this);
+    journal = &transaction;
+    try {
+        body();
+    } catch (...) {
+        journal = nullptr;
+        transaction.rollback();
+        throw;
+    }
+    journal = nullptr;
 
-        line.erase(0, line.find_first_not_of(" \t"));
-        line.erase(line.find_last_not_of(" \t") + 1);
+    if (!transaction.hasFailed()) return true;
+    transaction.rollback();
+    return false;
+}
 
-        if (line.empty()) continue;
+bool GameEngine::executeBlockAtomic(const ScriptBlock& block) {
+    return runTransaction([&]() { executeBlock(block); });
+}
 
-        if (line == "{") blockDepth++;
-        else if (line == "}") blockDepth--;
-        else if (execute && blockDepth == 1) parseLine(line);
+void GameEngine::runConcurrent(const CommandProgram& program) {
+    if (program.size() < PARALLEL_MIN_COMMANDS || std::thread::hardware_concurrency() < 2 ||
+        LoadProfiler::getInstance().isActive()) {
+        runProgram(program);
+        return;
     }
-}
 
-// 物品效果块处理
-void GameEngine::processItemEffectBlock(std::ifstream& fs, const std::string& headerLine, int& lineNumber) {
-    std::vector<std::string> tokens = tokenize(headerLine);
-    if(tokens.size() < 3 || tokens[2].back() != ':')
-        throw std::runtime_error("Invalid item effect format: " + headerLine);
-    
-    std::string itemName = tokens[2].substr(0, tokens[2].size()-1);
-    if(items.find(itemName) == items.end())
-        throw std::runtime_error("Undefined item: " + itemName);
+    std::vector<CommandAccess> accesses;
+    accesses.reserve(program.size());
+    for (const auto& command : program) accesses.push_back(CommandAccess::analyze(command));
 
-    int blockDepth = 1;
-    std::string line;
-    while (blockDepth > 0 && getline(fs, line)) {
-        lineNumber++;
-        line.erase(0, line.find_first_not_of(" \t"));
-        line.erase(line.find_last_not_of(" \t") + 1);
+    // 按源下标收集每条命令的错误，全部执行完后按源顺序记录（批次顺序与源顺序不一定一致）。
+    // char而非bool：各工作线程并发写不同下标
+    std::vector<std::vector<std::string>> messages(program.size());
+    std::vector<char> workerFailed(program.size(), 0);
+    auto executeSerial = [&](size_t index) {
+        CommandParser::DiagnosticsCapture capture(messages[index], true);
+        CommandParser::execute(program[index], *this);
+    };
+    for (const auto& wave : CommandAccess::planWaves(accesses)) {
+        // 同一地图的命令按源顺序在同一线程执行；记录到待构建地图的命令开销很小，留在主线程
+        std::map<std::string, std::vector<size_t>> groups;
+        std::vector<size_t> serial;
+        for (size_t index : wave) {
+            const std::string& mapName = accesses[index].map;
+            if (!mapName.empty() && !isDeferredMap(mapName)) groups[mapName].push_back(index);
+            else serial.push_back(index);
+        }
+        if (groups.empty() || (groups.size() == 1 && serial.empty())) {
+            for (size_t index : wave) executeSerial(index);
+            continue;
+        }
 
-        if(line == "{") blockDepth++;
-        else if(line == "}") blockDepth--;
-        else items[itemName].useEffects.push_back(line);
+        // 先在主线程取得目标地图（可能插入新地图），工作线程只访问各自的地图对象
+        std::vector<std::pair<GameMap*, const std::vector<size_t>*>> jobs;
+        for (const auto& [mapName, indices] : groups) jobs.emplace_back(&getMap(mapName), &indices);
+        if (journal) {
+            for (const auto& [map, indices] : jobs) {
+                for (size_t index : *indices) journal->record(program[index]);
+            }
+        }
+
+        // 批内命令互不冲突：工作线程只读物品定义，主线程的命令不写物品定义也不访问这些地图。
+        runWorkers(jobs.size(), [&](size_t i) {
+            for (size_t index : *jobs[i].second) {
+                if (CommandStatus status = MapCommand::apply(*jobs[i].first, program[index].args, items); !status) {
+                    messages[index].push_back("命令执行失败: " + status.message);
+                    workerFailed[index] = 1;
+                }
+            }
+        }, [&]() {
+            // 其余命令可能访问界面，始终在主线程执行
+            for (size_t index : serial) executeSerial(index);
+        });
     }
-}
 
-// 辅助方法
-std::vector<std::string> GameEngine::tokenize(const std::string& line) {
-    std::istringstream iss(line);
-    return {std::istream_iterator<std::string>{iss}, 
-            std::istream_iterator<std::string>{}};
+    for (size_t index = 0; index < program.size(); ++index) {
+        if (journal && workerFailed[index]) journal->markFailed();
+        for (auto& message : messages[index]) CommandParser::report(std::move(message));
+    }
 }
 
+// 辅助方法
 char GameEngine::dirToChar(int dx, int dy) {
     if(dx == 1) return 'r';
     if(dx == -1) return 'l';
@@ -139,8 +567,7 @@ char GameEngine::dirToChar(int dx, int dy) {
 }
 
 int GameEngine::generateItemInstanceId() {
-    static int counter = 0;
-    return ++counter;
+    return ++itemInstanceCounter;
 }
 
 bool GameEngine::evalCondition(const std::string& condition) {
@@ -184,10 +611,7 @@ void GameEngine::useItem(const GameObject& item) {
         return; 
     }
     
-    for (const std::string& effect : items[item.name].useEffects) {
-        std::vector<std::string> tokens = tokenize(effect);
-        runCommand(tokens);
-    }
+    runItemEffects(item);
     
     // 消耗品处理
     if (item.getProperty<int>("consumable", 0)) {
@@ -195,6 +619,32 @@ void GameEngine::useItem(const GameObject& item) {
     }
 }
 
+void GameEngine::runItemEffects(const GameObject& item) {
+    // 效果块和use_effects作为一个批量执行
+    runBatched([&]() {
+        PluginHost::getInstance().dispatch(*this, GAME_PLUGIN_EVENT_ITEM_USE, item.name);
+        auto it = itemEffects.find(item.name);
+        if (it != itemEffects.end()) runProgram(it->second);
+
+        // 实例上的use_effects属性：以';'分隔的多条命令
+        std::string extra = item.getProperty<std::string>("use_effects", "");
+        size_t start = 0;
+        while (start < extra.size()) {
+            size_t end = extra.find(';', start);
+            if (end == std::string::npos) end = extra.size();
+            parseLine(extra.substr(start, end - start));
+            start = end + 1;
+        }
+    });
+}
+
+void GameEngine::addItemEffects(const std::string& itemName, const std::vector<std::string>& lines, const CommandProgram& program) {
+    auto& source = items[itemName].useEffects;
+    source.insert(source.end(), lines.begin(), lines.end());
+    auto& compiled = itemEffects[itemName];
+    compiled.insert(compiled.end(), program.begin(), program.end());
+}
+
 void GameEngine::discardItem(const GameObject& item) {
     auto& currentMap = getCurrentMap();
     GameObject dropItem = item;
@@ -214,29 +664,50 @@ void GameEngine::discardItem(const GameObject& item) {
 
 // 文件加载入口
 void GameEngine::loadGame(const std::string& filename) {
-    std::ifstream fs(filename);
-    if (!fs.is_open()) throw std::runtime_error("无法打开游戏文件: " + filename);
-
-    int lineNumber = 0;
-    std::string line;
-    while (getline(fs, line)) {
-        lineNumber++;
-        size_t commentPos = line.find("//");
-        if (commentPos != std::string::npos)
-            line = line.substr(0, commentPos);
-        
-        line.erase(0, line.find_first_not_of(" \t"));
-        line.erase(line.find_last_not_of(" \t") + 1);
-        if (line.empty()) continue;
+    scriptFile = filename;
+    LoadProfiler::Session profile(filename, profiling);
+    MappedFile source(filename);
+    const std::uint64_t scriptHash = WorldSnapshot::hash(source.view(), strictLoading);
+    const std::string snapshotFile = WorldSnapshot::pathFor(filename);
 
-        if (line.find("init") == 0) processInitBlock(fs, lineNumber);
-        else if (line.find("if ") == 0) processIfBlock(fs, line.substr(3), lineNumber);
-        else if (line.find("item 使用效果") == 0) processItemEffectBlock(fs, line, lineNumber);
-        else throw std::runtime_error("顶层命令必须在init/if/item块内: " + line);
+    // 脚本未改动时直接从快照恢复（分析模式下总是执行脚本；插件状态不在快照中，有插件时也总是执行）
+    const bool cacheable = PluginHost::getInstance().empty();
+    if (!cacheable) {
+        Log log("error.log");
+        for (const auto& path : PluginHost::getInstance().loadedPaths()) log.info("已加载插件，不使用世界快照: ", path);
     }
+    if (profiling || !cacheable || !WorldSnapshot::load(*this, snapshotFile, scriptHash)) {
+        // 整个脚本先编译一次，再按块顺序执行；
+        // 非主地图的构建命令延迟到首次进入（分析模式下立即构建，开销计入所在行）
+        Script script;
+        {
+            LoadProfiler::Phase phase("编译");
+            script = Script::compile(source.view());
+        }
+        deferMapBuilding = !profiling;
+        for (const auto& block : script.getBlocks()) {
+            LoadProfiler::Phase phase(block);
+            if (!strictLoading) {
+                executeBlock(block);
+            } else if (!executeBlockAtomic(block)) {
+                Log log("error.log");
+                log.error("第", std::to_string(block.line), "行的块执行失败，已撤销该块的修改");
+            }
+        }
+        deferMapBuilding = false;
+        loadedScript = std::move(script);
 
-    if (!maps.count("main")) throw std::runtime_error("缺少主地图'main'");
-    currentMap = "main";
+        if (!maps.count("main")) throw std::runtime_error("缺少主地图'main'");
+        currentMap = "main";
+
+        // 加载过程中打开了对话等界面状态时不缓存（快照只记录世界数据）
+        if (cacheable && gameState == GameState::EXPLORING && !dialogSystem.getCurrentDialog()) {
+            LoadProfiler::Phase phase("写入快照");
+            WorldSnapshot::save(*this, snapshotFile, scriptHash);
+        }
+    }
+    
+    prefetchNeighbors();
     
 #ifdef DEBUG
     dialogSystem.showDialog({{"你好，旅行者！", "这是我的第二行对话内容"}, "测试对话功能"}, *this);
@@ -245,5 +716,6 @@ void GameEngine::loadGame(const std::string& filename) {
 
 // 游戏保存入口
 void GameEngine::saveGame(const std::string& filename) {
+    loadAllMaps(); // 存档需要完整的地图内容
     saveLoadManager.saveState(*this, filename);
 }
\ No newline at end of file
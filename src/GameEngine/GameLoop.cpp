@@ -0,0 +1,29 @@
+// File: src/GameEngine/GameLoop.cpp
+// 游戏主循环：终端界面部分（与Renderer、InputHandler一起只链接进游戏本体）
+#include "GameEngine.h"
+#include "InputHandler.h"
+#include "Renderer.h"
+#include <ncurses.h>
+
+namespace {
+constexpr int WATCH_POLL_MS = 200; ///< 热重载模式下检查脚本的间隔
+}
+
+// 核心游戏循环
+void GameEngine::startGameLoop() {
+    Renderer renderer;
+    InputHandler inputHandler(*this);
+    renderer.initScreen();
+    // 热重载模式下等待输入有超时，以便定期检查脚本
+    if (scriptWatcher) timeout(WATCH_POLL_MS);
+    while(true) {
+        renderer.render(*this);
+        int ch = getch();
+        if (ch != ERR) {
+            const bool consoleInput = gameState == GameState::CONSOLE;
+            inputHandler.processInput(ch);
+            if (!consoleInput && gameState != GameState::CONSOLE) tick();
+        }
+        if (scriptWatcher && scriptWatcher->poll()) reloadScript();
+    }
+}
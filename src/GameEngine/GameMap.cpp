@@ -1,10 +1,66 @@
 // File: src/GameMap.cpp
 #include "GameMap.h"
+#include "LoadProfiler.h"
+#include <algorithm>
+#include <mutex>
+
+namespace {
+// 全局实体ID分配状态；地图可在工作线程中构建，访问需加锁（只有带ID的对象才会触及）
+std::mutex entityIdMutex;
+GameMap::EntityIdState entityIds;
+
+void releaseEntityId(std::uint32_t id) {
+    if (id == 0) return;
+    std::lock_guard<std::mutex> lock(entityIdMutex);
+    entityIds.released.insert(id);
+}
+
+// 收回已释放的ID；ID仍被使用（或从未分配）时返回false
+bool reclaimEntityId(std::uint32_t id) {
+    std::lock_guard<std::mutex> lock(entityIdMutex);
+    return entityIds.released.erase(id) > 0;
+}
+}
 
 GameMap::GameMap(int w, int h) : width(w), height(h) {}
 
+GameMap::EntityIdState GameMap::entityIdState() {
+    std::lock_guard<std::mutex> lock(entityIdMutex);
+    return entityIds;
+}
+
+void GameMap::restoreEntityIdState(EntityIdState state) {
+    std::lock_guard<std::mutex> lock(entityIdMutex);
+    entityIds = std::move(state);
+}
+
+std::uint32_t GameMap::acquireEntityId() {
+    std::lock_guard<std::mutex> lock(entityIdMutex);
+    if (entityIds.released.empty()) return entityIds.next++;
+    const std::uint32_t id = *entityIds.released.begin();
+    entityIds.released.erase(entityIds.released.begin());
+    return id;
+}
+
 void GameMap::setObject(int x, int y, const GameObject& obj) {
-    objects[{x, y}] = obj;
+    LoadProfiler::countObjectWrite();
+    auto [it, inserted] = objects.try_emplace({x, y});
+    const std::uint32_t replacedId = inserted ? 0 : it->second.entityId;
+    std::uint32_t id = obj.entityId;
+    if (id != 0 && id != replacedId && !reclaimEntityId(id)) id = 0;
+    if (id == 0 && replacedId != 0 && it->second.name == obj.name && it->second.type == obj.type) id = replacedId;
+    if (replacedId != id) releaseEntityId(replacedId);
+    if (batching) {
+        // 每个坐标只在首次写入时移出索引
+        if (unindexed.insert(it->first).second && !inserted) unindexObject(it->first, it->second);
+    } else if (!inserted) {
+        unindexObject(it->first, it->second);
+    }
+    it->second = obj;
+    it->second.entityId = id;
+    it->second.x = x;
+    it->second.y = y;
+    if (!batching) indexObject(it->first, it->second);
 }
 
 GameObject GameMap::getObject(int x, int y) const {
@@ -13,7 +69,73 @@ GameObject GameMap::getObject(int x, int y) const {
 }
 
 void GameMap::removeObject(int x, int y) {
-    objects.erase({x, y});
+    auto it = objects.find({x, y});
+    if (it == objects.end()) return;
+    LoadProfiler::countObjectWrite();
+    // 批量写入中已移出索引的坐标只需从待加入集合中去掉
+    if (!batching || unindexed.erase(it->first) == 0) unindexObject(it->first, it->second);
+    releaseEntityId(it->second.entityId);
+    objects.erase(it);
+}
+
+void GameMap::clear() {
+    for (const auto& [pos, obj] : objects) releaseEntityId(obj.entityId);
+    objects.clear();
+    nameIndex.clear();
+    typeIndex.clear();
+    nameTrie = PrefixTrie();
+    unindexed.clear();
+}
+
+void GameMap::endBatch() {
+    flushIndex();
+    batching = false;
+}
+
+void GameMap::flushIndex() const {
+    if (unindexed.empty()) return;
+    for (const auto& pos : unindexed) {
+        auto it = objects.find(pos);
+        if (it == objects.end()) continue;
+        const GameObject& obj = it->second;
+        // 坐标按顺序加入，以末尾为提示插入
+        if (!obj.name.empty()) {
+            auto [entry, added] = nameIndex.try_emplace(obj.name);
+            if (added) nameTrie.insert(obj.name);
+            entry->second.insert(entry->second.end(), pos);
+        }
+        if (!obj.type.empty()) {
+            PositionSet& positions = typeIndex[obj.type];
+            positions.insert(positions.end(), pos);
+        }
+    }
+    unindexed.clear();
+}
+
+std::vector<GameObject> GameMap::copyArea(int x1, int y1, int x2, int y2) const {
+    // 对象按(x,y)有序，逐列取区间，只访问区域内已有的对象
+    std::vector<GameObject> copied;
+    for (int x = std::min(x1, x2); x <= std::max(x1, x2); ++x) {
+        auto end = objects.upper_bound({x, std::max(y1, y2)});
+        for (auto it = objects.lower_bound({x, std::min(y1, y2)}); it != end; ++it) copied.push_back(it->second);
+    }
+    return copied;
+}
+
+void GameMap::restoreArea(int x1, int y1, int x2, int y2, const std::vector<GameObject>& before) {
+    flushIndex();
+    for (int x = std::min(x1, x2); x <= std::max(x1, x2); ++x) {
+        auto it = objects.lower_bound({x, std::min(y1, y2)});
+        auto end = objects.upper_bound({x, std::max(y1, y2)});
+        while (it != end) {
+            unindexObject(it->first, it->second);
+            it = objects.erase(it);
+        }
+    }
+    for (const auto& obj : before) {
+        auto it = objects.insert_or_assign({obj.x, obj.y}, obj).first;
+        indexObject(it->first, it->second);
+    }
 }
 
 bool GameMap::hasObject(int x, int y) const {
@@ -21,17 +143,65 @@ bool GameMap::hasObject(int x, int y) const {
 }
 
 bool GameMap::hasObject(const std::string& name) const {
-    for (const auto& [coord, obj] : objects) {
-        if (obj.name == name) return true;
-    }
-    return false;
+    flushIndex();
+    return nameIndex.count(name) > 0;
 }
 
 GameObject GameMap::getObjectByName(const std::string& name) const {
-    for (const auto& [coord, obj] : objects) {
-        if (obj.name == name) return obj;
+    flushIndex();
+    auto it = nameIndex.find(name);
+    return it != nameIndex.end() ? objects.at(*it->second.begin()) : GameObject();
+}
+
+GameObject* GameMap::findObjectByName(const std::string& name) {
+    flushIndex();
+    auto it = nameIndex.find(name);
+    return it != nameIndex.end() ? &objects.at(*it->second.begin()) : nullptr;
+}
+
+GameObject* GameMap::findObject(int x, int y) {
+    auto it = objects.find({x, y});
+    return it != objects.end() ? &it->second : nullptr;
+}
+
+const GameMap::PositionSet* GameMap::positionsByName(const std::string& name) const {
+    flushIndex();
+    auto it = nameIndex.find(name);
+    return it != nameIndex.end() ? &it->second : nullptr;
+}
+
+const GameMap::PositionSet* GameMap::positionsByType(const std::string& type) const {
+    flushIndex();
+    auto it = typeIndex.find(type);
+    return it != typeIndex.end() ? &it->second : nullptr;
+}
+
+void GameMap::indexObject(const std::pair<int, int>& pos, const GameObject& obj) const {
+    if (!obj.name.empty()) {
+        auto [entry, added] = nameIndex.try_emplace(obj.name);
+        if (added) nameTrie.insert(obj.name);
+        entry->second.insert(pos);
     }
-    return GameObject();
+    if (!obj.type.empty()) typeIndex[obj.type].insert(pos);
+}
+
+void GameMap::unindexObject(const std::pair<int, int>& pos, const GameObject& obj) const {
+    // 返回该键是否已从索引中移除
+    auto eraseFrom = [&](std::unordered_map<std::string, PositionSet>& index, const std::string& key) {
+        auto it = index.find(key);
+        if (it == index.end()) return false;
+        it->second.erase(pos);
+        if (!it->second.empty()) return false;
+        index.erase(it);
+        return true;
+    };
+    if (eraseFrom(nameIndex, obj.name)) nameTrie.erase(obj.name);
+    eraseFrom(typeIndex, obj.type);
+}
+
+std::vector<std::string> GameMap::completeName(std::string_view prefix, std::size_t limit) const {
+    flushIndex();
+    return nameTrie.complete(prefix, limit);
 }
 
 bool GameMap::isWalkable(int x, int y) const {
@@ -45,10 +215,7 @@ bool GameMap::isWalkable(int x, int y) const {
 void GameMap::fillArea(int x1, int y1, int x2, int y2, const GameObject& templateObj) {
     for (int x = std::min(x1, x2); x <= std::max(x1, x2); ++x) {
         for (int y = std::min(y1, y2); y <= std::max(y1, y2); ++y) {
-            GameObject obj = templateObj;
-            obj.x = x;
-            obj.y = y;
-            setObject(x, y, obj);
+            setObject(x, y, templateObj);
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+// src/GameEngine/GlyphTable.cpp
+#include "GlyphTable.h"
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// 解码一个UTF-8码点，返回消耗的字节数（非法序列按单字节处理）
+std::size_t decodeUtf8(std::string_view s, std::size_t pos, char32_t& cp) {
+    const auto b0 = static_cast<unsigned char>(s[pos]);
+    std::size_t len = b0 < 0x80 ? 1 : (b0 >> 5) == 0x6 ? 2 : (b0 >> 4) == 0xE ? 3 : (b0 >> 3) == 0x1E ? 4 : 0;
+    if (len == 0 || pos + len > s.size()) {
+        cp = U'?';
+        return 1;
+    }
+    cp = len == 1 ? b0 : b0 & (0x7F >> len);
+    for (std::size_t i = 1; i < len; ++i) {
+        const auto b = static_cast<unsigned char>(s[pos + i]);
+        if ((b & 0xC0) != 0x80) {
+            cp = U'?';
+            return 1;
+        }
+        cp = (cp << 6) | (b & 0x3F);
+    }
+    return len;
+}
+
+// 附着在前一个码点上的字符（组合符、变体选择符、肤色修饰符等）
+bool isExtending(char32_t cp) {
+    return (cp >= 0x0300 && cp <= 0x036F) || (cp >= 0x1AB0 && cp <= 0x1AFF) ||
+           (cp >= 0x20D0 && cp <= 0x20FF) || (cp >= 0xFE00 && cp <= 0xFE0F) ||
+           (cp >= 0xFE20 && cp <= 0xFE2F) || (cp >= 0x1F3FB && cp <= 0x1F3FF) ||
+           (cp >= 0xE0020 && cp <= 0xE007F) || cp == 0x200D;
+}
+
+// 东亚宽字符与常见emoji区段占两列
+bool isWide(char32_t cp) {
+    return (cp >= 0x1100 && cp <= 0x115F) || (cp >= 0x2E80 && cp <= 0xA4CF) ||
+           (cp >= 0xAC00 && cp <= 0xD7A3) || (cp >= 0xF900 && cp <= 0xFAFF) ||
+           (cp >= 0xFE30 && cp <= 0xFE4F) || (cp >= 0xFF00 && cp <= 0xFF60) ||
+           (cp >= 0xFFE0 && cp <= 0xFFE6) || (cp >= 0x1F300 && cp <= 0x1F64F) ||
+           (cp >= 0x1F900 && cp <= 0x1F9FF) || (cp >= 0x20000 && cp <= 0x3FFFD);
+}
+
+// 截取文本开头的字素簇（ZWJ连接的后续码点也归入同一簇）
+std::string_view firstCluster(std::string_view text, std::vector<char32_t>& codepoints) {
+    std::size_t pos = 0;
+    char32_t cp;
+    pos += decodeUtf8(text, pos, cp);
+    codepoints.push_back(cp);
+    bool joined = false;
+    while (pos < text.size()) {
+        std::size_t len = decodeUtf8(text, pos, cp);
+        if (!joined && !isExtending(cp)) break;
+        joined = (cp == 0x200D);
+        codepoints.push_back(cp);
+        pos += len;
+    }
+    return text.substr(0, pos);
+}
+
+} // namespace
+
+GlyphTable::GlyphTable() {
+    // 预置ASCII字形，使ID与字符码相同
+    for (int c = 0; c < 128; ++c) {
+        internImpl(std::string(1, static_cast<char>(c)));
+    }
+}
+
+GlyphId GlyphTable::intern(std::string_view text) {
+    if (text.empty()) return ' ';
+    if (static_cast<unsigned char>(text[0]) < 0x80 &&
+        (text.size() == 1 || static_cast<unsigned char>(text[1]) < 0x80)) {
+        return static_cast<GlyphId>(text[0]);
+    }
+    return getInstance().internImpl(text);
+}
+
+const Glyph& GlyphTable::get(GlyphId id) {
+    GlyphTable& table = getInstance();
+    if (id >= table.count.load(std::memory_order_acquire)) return table.slot('?');
+    return table.slot(id);
+}
+
+GlyphId GlyphTable::internImpl(std::string_view text) {
+    std::vector<char32_t> codepoints;
+    std::string cluster(firstCluster(text, codepoints));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(cluster);
+    if (it != index.end()) return it->second;
+
+    std::size_t id = count.load(std::memory_order_relaxed);
+    if (id >= MAX_GLYPHS) throw std::runtime_error("字形数量超过上限: " + cluster);
+    if (!chunks[id / CHUNK_SIZE]) chunks[id / CHUNK_SIZE] = std::make_unique<Glyph[]>(CHUNK_SIZE);
+
+    Glyph& glyph = slot(id);
+    glyph.text = cluster;
+    glyph.width = isWide(codepoints[0]) ? 2 : 1;
+    for (char32_t cp : codepoints) {
+        if (cp == 0xFE0F) glyph.width = 2; // emoji表现形式
+    }
+    glyph.codepoints.assign(codepoints.begin(), codepoints.end());
+
+    index.emplace(std::move(cluster), static_cast<GlyphId>(id));
+    count.store(id + 1, std::memory_order_release);
+    return static_cast<GlyphId>(id);
+}
@@ -32,6 +32,12 @@ void InputHandler::processInput(int key) {
             handleDialog(key);
 #ifdef DEBUG
             log.debug("DIALOG(对话)状态");
+#endif
+            break;
+        case static_cast<int>(GameState::CONSOLE):
+            handleConsole(key);
+#ifdef DEBUG
+            log.debug("CONSOLE(控制台)状态");
 #endif
             break;
     }
@@ -63,6 +69,9 @@ void InputHandler::handleExploring(int key) {
                 engine.getDialogSystem().showDialog({{"物品栏为空"}, "系统"}, engine);
             }
             break;
+        case '`':
+            engine.setGameState(GameState::CONSOLE);
+            break;
         case 'q':
             endwin();
             exit(0);
@@ -157,4 +166,37 @@ void InputHandler::handleDialog(int key) {
         engine.getDialogSystem().closeDialog(engine);
         engine.setGameState(GameState::EXPLORING);
     }
-}
\ No newline at end of file
+}
+
+void InputHandler::handleConsole(int key) {
+    Console& console = engine.getConsole();
+    switch (key) {
+        case 27: // ESC
+        case '`':
+            engine.setGameState(GameState::EXPLORING);
+            break;
+        case '\n':
+        case KEY_ENTER:
+            // 命令可能打开对话框（切换到对话状态）
+            console.submit(engine);
+            break;
+        case '\t':
+            console.complete(engine);
+            break;
+        case KEY_UP:
+            console.historyPrev();
+            break;
+        case KEY_DOWN:
+            console.historyNext();
+            break;
+        case KEY_BACKSPACE:
+        case 127:
+        case '\b':
+            console.backspace();
+            break;
+        default:
+            // 可打印字符和UTF-8字节（功能键的键值大于255）
+            if (key >= ' ' && key < 256) console.insert(static_cast<char>(key));
+            break;
+    }
+}
@@ -39,12 +39,8 @@ void InventoryManager::removeItem(const GameObject& item) {
 }
 
 void InventoryManager::useItem(GameObject& item, GameEngine& engine) {
-    // 执行使用效果
-    std::string effectsStr = item.getProperty<std::string>("use_effects", "");
-    std::vector<std::string> useEffects = engine.tokenize(effectsStr);
-    for(const auto& effect : useEffects) {
-        engine.runCommand(engine.tokenize(effect));
-    }
+    // 执行使用效果（与GameEngine::useItem共用预编译程序）
+    engine.runItemEffects(item);
     
     // 消耗品处理
     if(item.getProperty("consumable", 0)) {
@@ -0,0 +1,234 @@
+// src/GameEngine/LoadProfiler.cpp
+#include "LoadProfiler.h"
+#include "CommandSchema.h"
+#include "Log.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+thread_local LoadProfiler::Counters LoadProfiler::threadCounters;
+thread_local int LoadProfiler::commandDepth = 0;
+
+namespace {
+
+constexpr std::size_t MAX_REPORT_LINES = 100; ///< 报告中列出的源码行数上限
+constexpr std::size_t MAX_LINE_TEXT = 60;      ///< 报告中命令文本的最大字节数
+
+std::uint64_t elapsedNanos(Clock::time_point start) {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+// 命令类型：命令名加子命令（/teleport没有子命令）
+std::string commandType(const CompiledCommand& command) {
+    if (!command.subcommand || command.subcommand->getName().empty()) return command.args[0];
+    return command.args[0] + " " + command.subcommand->getName();
+}
+
+// 报告中显示的命令文本（按UTF-8字符边界截断）
+std::string commandText(const std::vector<std::string>& args) {
+    std::string text;
+    for (const auto& arg : args) {
+        if (!text.empty()) text += ' ';
+        text += arg;
+    }
+    if (text.size() > MAX_LINE_TEXT) {
+        std::size_t cut = MAX_LINE_TEXT;
+        while (cut > 0 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) --cut;
+        text = text.substr(0, cut) + "...";
+    }
+    return text;
+}
+
+// 折叠栈的帧名不能包含';'和换行
+std::string frameName(std::string name) {
+    std::replace(name.begin(), name.end(), ';', ',');
+    std::replace(name.begin(), name.end(), '\n', ' ');
+    return name;
+}
+
+std::string millis(std::uint64_t nanos) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3) << nanos / 1e6;
+    return out.str();
+}
+
+void add(LoadProfiler::Sample& target, const LoadProfiler::Sample& sample) {
+    target.count += sample.count;
+    target.nanos += sample.nanos;
+    target.allocations += sample.allocations;
+    target.writes += sample.writes;
+}
+
+// 按耗时降序排列的条目
+template<typename Key, typename Value, typename Nanos>
+std::vector<std::pair<Key, const Value*>> sortedByTime(const std::map<Key, Value>& entries, Nanos nanosOf) {
+    std::vector<std::pair<Key, const Value*>> sorted;
+    for (const auto& [key, value] : entries) sorted.emplace_back(key, &value);
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [&](const auto& a, const auto& b) { return nanosOf(*a.second) > nanosOf(*b.second); });
+    return sorted;
+}
+
+} // namespace
+
+LoadProfiler::Session::Session(const std::string& scriptFile, bool enabled) : enabled(enabled) {
+    if (enabled) getInstance().begin(scriptFile);
+}
+
+LoadProfiler::Session::~Session() {
+    if (enabled) getInstance().end();
+}
+
+LoadProfiler::Phase::Phase(std::string name) : enabled(getInstance().isActive()) {
+    if (enabled) open(std::move(name));
+}
+
+LoadProfiler::Phase::Phase(const ScriptBlock& block) : enabled(getInstance().isActive()) {
+    if (!enabled) return;
+    std::string name;
+    switch (block.kind) {
+        case ScriptBlock::Kind::INIT: name = "init"; break;
+        case ScriptBlock::Kind::IF: name = "if " + block.header; break;
+        case ScriptBlock::Kind::ITEM_EFFECT: name = "item " + block.header; break;
+    }
+    open(name + "(第" + std::to_string(block.line) + "行)");
+}
+
+void LoadProfiler::Phase::open(std::string name) {
+    LoadProfiler& profiler = getInstance();
+    profiler.phase = frameName(std::move(name));
+    start = Clock::now();
+    before = threadCounters;
+    commandNanos = profiler.total.nanos;
+}
+
+LoadProfiler::Phase::~Phase() {
+    if (!enabled) return;
+    LoadProfiler& profiler = getInstance();
+    Sample sample;
+    sample.count = 1;
+    sample.nanos = elapsedNanos(start);
+    sample.allocations = threadCounters.allocations - before.allocations;
+    sample.writes = threadCounters.writes - before.writes;
+    add(profiler.phases[profiler.phase], sample);
+
+    // 阶段自身的耗时（不含命令）作为单独的栈
+    const std::uint64_t commands = profiler.total.nanos - commandNanos;
+    if (sample.nanos > commands) {
+        profiler.folded[frameName(profiler.scriptFile) + ";" + profiler.phase] += sample.nanos - commands;
+    }
+    profiler.phase.clear();
+}
+
+LoadProfiler::CommandScope::CommandScope(const CompiledCommand& command) : command(nullptr) {
+    if (!getInstance().isActive() || commandDepth++ > 0 || command.args.empty()) return;
+    this->command = &command;
+    before = threadCounters;
+    start = Clock::now();
+}
+
+LoadProfiler::CommandScope::~CommandScope() {
+    if (!getInstance().isActive()) return;
+    --commandDepth;
+    if (!command) return;
+    Sample sample;
+    sample.count = 1;
+    sample.nanos = elapsedNanos(start);
+    sample.allocations = threadCounters.allocations - before.allocations;
+    sample.writes = threadCounters.writes - before.writes;
+    getInstance().recordCommand(*command, sample);
+}
+
+void LoadProfiler::begin(const std::string& file) {
+    active = true;
+    scriptFile = file;
+    phase.clear();
+    phases.clear();
+    commandTypes.clear();
+    lines.clear();
+    folded.clear();
+    total = Sample();
+    commandDepth = 0;
+    sessionStart = Clock::now();
+}
+
+void LoadProfiler::end() {
+    const std::uint64_t sessionNanos = elapsedNanos(sessionStart);
+    active = false;
+    try {
+        writeReport(sessionNanos);
+        writeFolded();
+    } catch (const std::exception& e) {
+        Log log("error.log");
+        log.error("无法写入加载分析报告: ", e.what());
+    }
+}
+
+void LoadProfiler::recordCommand(const CompiledCommand& command, const Sample& sample) {
+    const std::uint64_t allocations = threadCounters.allocations; // 分析器自身的分配不计入
+    add(total, sample);
+    const std::string type = commandType(command);
+    add(commandTypes[type], sample);
+
+    std::string stack = frameName(scriptFile);
+    if (!phase.empty()) stack += ";" + phase;
+    if (command.line > 0) {
+        LineSample& line = lines[command.line];
+        if (line.text.empty()) line.text = commandText(command.args);
+        add(line.sample, sample);
+        stack += ";第" + std::to_string(command.line) + "行";
+    }
+    folded[stack + ";" + frameName(type)] += sample.nanos;
+    threadCounters.allocations = allocations;
+}
+
+void LoadProfiler::writeReport(std::uint64_t sessionNanos) const {
+    std::ofstream out(scriptFile + ".profile.txt");
+    if (!out) throw std::runtime_error("无法打开: " + scriptFile + ".profile.txt");
+
+    out << "加载分析: " << scriptFile << "\n"
+        << "总耗时 " << millis(sessionNanos) << " ms，命令 " << total.count << " 条（"
+        << millis(total.nanos) << " ms），内存分配 "
+        << (allocationsCounted ? std::to_string(total.allocations) + " 次" : "未统计（需以GAME_COUNT_ALLOCATIONS构建）")
+        << "，对象写入 "
+        << total.writes << " 次\n";
+
+    auto row = [&out](const std::string& name, const Sample& sample) {
+        out << std::right << std::setw(10) << sample.count << std::setw(12) << millis(sample.nanos)
+            << std::setw(12) << sample.allocations << std::setw(10) << sample.writes << "  " << name << "\n";
+    };
+    auto header = [&out](const std::string& title, const std::string& name) {
+        // 中文表头按显示宽度对齐数值列
+        out << "\n" << title << "\n" << "      次数    耗时(ms)        分配      写入  " << name << "\n";
+    };
+
+    header("按加载阶段（按耗时排序）", "阶段");
+    for (const auto& [name, sample] : sortedByTime(phases, [](const Sample& s) { return s.nanos; })) {
+        row(name, *sample);
+    }
+
+    header("按命令类型（按耗时排序）", "命令");
+    for (const auto& [type, sample] : sortedByTime(commandTypes, [](const Sample& s) { return s.nanos; })) {
+        row(type, *sample);
+    }
+
+    header("按源码行（耗时最多的前" + std::to_string(MAX_REPORT_LINES) + "行）", "行号: 命令");
+    auto sortedLines = sortedByTime(lines, [](const LineSample& s) { return s.sample.nanos; });
+    if (sortedLines.size() > MAX_REPORT_LINES) sortedLines.resize(MAX_REPORT_LINES);
+    for (const auto& [line, entry] : sortedLines) {
+        row(std::to_string(line) + ": " + entry->text, entry->sample);
+    }
+}
+
+void LoadProfiler::writeFolded() const {
+    std::ofstream out(scriptFile + ".folded");
+    if (!out) throw std::runtime_error("无法打开: " + scriptFile + ".folded");
+    for (const auto& [stack, nanos] : folded) {
+        if (nanos > 0) out << stack << " " << nanos << "\n";
+    }
+}
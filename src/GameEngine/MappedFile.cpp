@@ -0,0 +1,59 @@
+// src/GameEngine/MappedFile.cpp
+#include "MappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename) {
+    std::ifstream fs(filename, std::ios::binary);
+    if (!fs.is_open()) throw std::runtime_error("无法打开文件: " + filename);
+    std::ostringstream ss;
+    ss << fs.rdbuf();
+    buffer = ss.str();
+    data = buffer.data();
+    size = buffer.size();
+}
+
+MappedFile::~MappedFile() = default;
+
+#else
+
+MappedFile::MappedFile(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("无法打开文件: " + filename);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("无法读取文件信息: " + filename);
+    }
+    size = static_cast<std::size_t>(st.st_size);
+
+    // 空文件无法映射，直接视为空内容
+    if (size > 0) {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("无法映射文件: " + filename);
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+    }
+    close(fd); // 映射建立后即可关闭描述符
+}
+
+MappedFile::~MappedFile() {
+    if (data && size > 0) munmap(const_cast<char*>(data), size);
+}
+
+#endif
@@ -0,0 +1,377 @@
+// src/GameEngine/PluginHost.cpp
+#include "PluginHost.h"
+#include "CommandParser.h"
+#include "CommandUtils.h"
+#include "ConditionEvaluator.h"
+#include "GameEngine.h"
+#include "Log.h"
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+namespace {
+
+constexpr size_t INLINE_ARGS = 16; ///< 参数不超过该数量时argv放在栈上
+
+GameEngineHandle* toHandle(GameEngine& engine) { return reinterpret_cast<GameEngineHandle*>(&engine); }
+GameEngine& toEngine(GameEngineHandle* handle) { return *reinterpret_cast<GameEngine*>(handle); }
+
+// 以C字符串数组调用插件回调（参数较少时不分配内存）
+template<typename Call>
+auto withArgv(const std::vector<std::string>& args, Call call) {
+    const char* inlineArgv[INLINE_ARGS];
+    std::vector<const char*> heapArgv;
+    const char** argv = inlineArgv;
+    if (args.size() > INLINE_ARGS) {
+        heapArgv.resize(args.size());
+        argv = heapArgv.data();
+    }
+    for (size_t i = 0; i < args.size(); ++i) argv[i] = args[i].c_str();
+    return call(static_cast<int>(args.size()), argv);
+}
+
+// 插件注册的命令：参数原样交给插件解析
+class PluginCommand : public CommandHandler {
+public:
+    PluginCommand(const std::string& name, GamePluginCommandFn fn, void* userData)
+        : CommandHandler(name, false), fn(fn), userData(userData) {}
+
+    CommandStatus handle(const std::vector<std::string>& args, GameEngine& engine) override {
+        const char* error = withArgv(args, [&](int argc, const char** argv) {
+            return fn(toHandle(engine), argc, argv, userData);
+        });
+        if (error) return CommandStatus::failure(args[0] + ": " + error);
+        return CommandStatus::success();
+    }
+
+private:
+    GamePluginCommandFn fn;
+    void* userData;
+};
+
+// 按名称查找地图实体：与计分接口和/entity set一致，只构建放置了该实体的待构建地图
+GameObject* locate(GameEngine& engine, const char* name) {
+    return name ? engine.findEntity(name) : nullptr;
+}
+
+// 接口函数不能把异常抛进插件：记录错误后返回失败值
+template<typename Result, typename Body>
+Result guarded(Result fallback, Body body) {
+    try {
+        return body();
+    } catch (const std::exception& e) {
+        CommandParser::report(std::string("插件接口调用失败: ") + e.what());
+        return fallback;
+    }
+}
+
+} // namespace
+
+// 提供给插件的函数表实现
+struct PluginApiImpl {
+    using Module = PluginHost::Module;
+
+    static Module* staging(GamePluginContext* context, const char* name) {
+        auto* module = reinterpret_cast<Module*>(context);
+        return module && module->initializing && name && *name ? module : nullptr;
+    }
+
+    static int registerCommand(GamePluginContext* context, const char* name, GamePluginCommandFn fn, void* userData) {
+        Module* module = staging(context, name);
+        if (!module || !fn || name[0] != '/' || CommandParser::hasCommand(name)) return -1;
+        for (const auto& entry : module->commands) {
+            if (entry.first == name) return -1;
+        }
+        module->commands.emplace_back(name, PluginHost::Callback<GamePluginCommandFn>{fn, userData});
+        return 0;
+    }
+
+    static int registerPredicate(GamePluginContext* context, const char* name, GamePluginPredicateFn fn, void* userData) {
+        Module* module = staging(context, name);
+        // 内置条件关键字不能被覆盖
+        const std::string key = name ? name : "";
+        if (!module || !fn || key == "have" || key == "去过" || key == "and" || key == "or" || key == "not" ||
+            PluginHost::getInstance().predicates.count(key)) {
+            return -1;
+        }
+        for (const auto& entry : module->predicates) {
+            if (entry.first == key) return -1;
+        }
+        module->predicates.emplace_back(key, PluginHost::Predicate{fn, userData});
+        return 0;
+    }
+
+    static int registerEventHandler(GamePluginContext* context, int event, GamePluginEventFn fn, void* userData) {
+        auto* module = reinterpret_cast<Module*>(context);
+        if (!module || !module->initializing || !fn || event < 0 || event >= GAME_PLUGIN_EVENT_COUNT) return -1;
+        module->handlers.emplace_back(event, PluginHost::EventHandler{fn, userData});
+        return 0;
+    }
+
+    static int getVariable(GameEngineHandle* handle, const char* name, int* value) {
+        if (!name || !value) return 0;
+        const auto& variables = toEngine(handle).getVariables();
+        auto it = variables.find(name);
+        if (it == variables.end()) return 0;
+        *value = it->second;
+        return 1;
+    }
+
+    static void setVariable(GameEngineHandle* handle, const char* name, int value) {
+        if (!name) return;
+        GameEngine& engine = toEngine(handle);
+        if (UndoJournal* journal = engine.getJournal()) journal->recordVariable(name);
+        engine.getVariables()[name] = value;
+    }
+
+    static int getScore(GameEngineHandle* handle, const char* entity, const char* objective, int* value) {
+        return guarded(0, [&]() {
+            GameEngine& engine = toEngine(handle);
+            if (!objective || !value || !engine.getScoreboard().hasObjective(objective)) return 0;
+            // 待构建地图上的实体还没有计分，不为读取而构建地图（与条件中的实体计分项一致）
+            const std::string name = entity ? entity : "";
+            if (GameObject* obj = engine.findBuiltEntity(name)) {
+                *value = engine.getScoreboard().get(objective, obj->entityId);
+                return 1;
+            }
+            if (!engine.hasPendingEntity(name)) return 0;
+            *value = engine.getScoreboard().get(objective, 0);
+            return 1;
+        });
+    }
+
+    static int setScore(GameEngineHandle* handle, const char* entity, const char* objective, int value) {
+        return guarded(0, [&]() {
+            GameEngine& engine = toEngine(handle);
+            if (!objective || !engine.getScoreboard().hasObjective(objective)) return 0;
+            GameObject* obj = engine.findEntity(entity ? entity : "");
+            if (!obj) return 0;
+            if (UndoJournal* journal = engine.getJournal()) journal->recordObjective(objective);
+            engine.getScoreboard().apply(objective, "=", {engine.getScoreboard().track(*obj)}, value);
+            return 1;
+        });
+    }
+
+    static int getEntityInt(GameEngineHandle* handle, const char* entity, const char* key, int* value) {
+        return guarded(0, [&]() {
+            GameObject* obj = locate(toEngine(handle), entity);
+            if (!obj || !key || !value) return 0;
+            auto it = obj->properties.find(key);
+            if (it == obj->properties.end()) return 0;
+            // 脚本中/entity set设置的属性是字符串
+            std::optional<int> number;
+            if (const int* stored = std::get_if<int>(&it->second)) number = *stored;
+            else if (const std::string* text = std::get_if<std::string>(&it->second)) number = CommandUtils::toInt(*text);
+            if (!number) return 0;
+            *value = *number;
+            return 1;
+        });
+    }
+
+    static int setEntityInt(GameEngineHandle* handle, const char* entity, const char* key, int value) {
+        return guarded(0, [&]() {
+            GameEngine& engine = toEngine(handle);
+            if (!entity || !key) return 0;
+            // 先记录（实体在待构建地图上时记录原构建命令），再查找
+            if (UndoJournal* journal = engine.getJournal()) journal->recordMapEntity(entity);
+            GameObject* obj = locate(engine, entity);
+            if (!obj) return 0;
+            obj->setProperty(key, value);
+            return 1;
+        });
+    }
+
+    static int getEntityPosition(GameEngineHandle* handle, const char* entity, int* x, int* y) {
+        return guarded(0, [&]() {
+            GameObject* obj = locate(toEngine(handle), entity);
+            if (!obj || !x || !y) return 0;
+            *x = obj->x;
+            *y = obj->y;
+            return 1;
+        });
+    }
+
+    static void getPlayerPosition(GameEngineHandle* handle, int* x, int* y) {
+        const GameEngine& engine = toEngine(handle);
+        if (x) *x = engine.getPlayerX();
+        if (y) *y = engine.getPlayerY();
+    }
+
+    static void setPlayerPosition(GameEngineHandle* handle, int x, int y) {
+        GameEngine& engine = toEngine(handle);
+        if (UndoJournal* journal = engine.getJournal()) journal->recordPlayer();
+        engine.setPlayerX(x);
+        engine.setPlayerY(y);
+        guarded(0, [&]() { engine.updateViewport(); return 0; });
+    }
+
+    static const char* getCurrentMap(GameEngineHandle* handle) {
+        return toEngine(handle).getCurrentMapName().c_str();
+    }
+
+    static const char* getObjectType(GameEngineHandle* handle, int x, int y) {
+        return guarded<const char*>(nullptr, [&]() -> const char* {
+            GameObject* obj = toEngine(handle).getCurrentMap().findObject(x, y);
+            return obj ? obj->type.c_str() : nullptr;
+        });
+    }
+
+    static int isWalkable(GameEngineHandle* handle, int x, int y) {
+        return guarded(0, [&]() { return toEngine(handle).getCurrentMap().isWalkable(x, y) ? 1 : 0; });
+    }
+
+    static int hasItem(GameEngineHandle* handle, const char* item) {
+        if (!item) return 0;
+        const auto& inventory = toEngine(handle).getInventory();
+        return std::any_of(inventory.begin(), inventory.end(), [&](const GameObject& obj) {
+            return obj.name == item && obj.getProperty("count", 1) > 0;
+        }) ? 1 : 0;
+    }
+
+    static void runCommand(GameEngineHandle* handle, const char* line) {
+        if (!line) return;
+        guarded(0, [&]() { toEngine(handle).parseLine(line); return 0; });
+    }
+
+    static void reportError(GameEngineHandle*, const char* message) {
+        if (message) CommandParser::report(std::string("插件: ") + message);
+    }
+};
+
+const GamePluginApi PluginHost::API = {
+    GAME_PLUGIN_ABI_VERSION,
+    sizeof(GamePluginApi),
+    &PluginApiImpl::registerCommand,
+    &PluginApiImpl::registerPredicate,
+    &PluginApiImpl::registerEventHandler,
+    &PluginApiImpl::getVariable,
+    &PluginApiImpl::setVariable,
+    &PluginApiImpl::getScore,
+    &PluginApiImpl::setScore,
+    &PluginApiImpl::getEntityInt,
+    &PluginApiImpl::setEntityInt,
+    &PluginApiImpl::getEntityPosition,
+    &PluginApiImpl::getPlayerPosition,
+    &PluginApiImpl::setPlayerPosition,
+    &PluginApiImpl::getCurrentMap,
+    &PluginApiImpl::getObjectType,
+    &PluginApiImpl::isWalkable,
+    &PluginApiImpl::hasItem,
+    &PluginApiImpl::runCommand,
+    &PluginApiImpl::reportError,
+};
+
+std::string PluginHost::directoryFor(const std::string& scriptFile) {
+    return (std::filesystem::path(scriptFile).parent_path() / "plugins").string();
+}
+
+bool PluginHost::load(const std::string& path) {
+    Log log("error.log");
+#ifdef _WIN32
+    log.error("当前平台不支持原生插件: ", path);
+    return false;
+#else
+    // 不含'/'的路径dlopen会搜索系统库目录
+    const std::string file = path.find('/') == std::string::npos ? "./" + path : path;
+    void* handle = dlopen(file.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        log.error("无法加载插件: ", dlerror());
+        return false;
+    }
+
+    using VersionFn = std::uint32_t (*)();
+    using InitFn = int (*)(const GamePluginApi*, GamePluginContext*);
+    auto version = reinterpret_cast<VersionFn>(dlsym(handle, "game_plugin_abi_version"));
+    auto init = reinterpret_cast<InitFn>(dlsym(handle, "game_plugin_init"));
+    if (!version || !init) {
+        log.error("插件缺少入口函数game_plugin_abi_version或game_plugin_init: ", path);
+        dlclose(handle);
+        return false;
+    }
+    if (version() != GAME_PLUGIN_ABI_VERSION) {
+        log.error("插件接口版本不符: ", path, "（插件", std::to_string(version()),
+                  "，引擎", std::to_string(GAME_PLUGIN_ABI_VERSION), "）");
+        dlclose(handle);
+        return false;
+    }
+
+    Module& module = modules.emplace_back();
+    module.path = path;
+    module.handle = handle;
+    module.shutdown = reinterpret_cast<void (*)()>(dlsym(handle, "game_plugin_shutdown"));
+    module.initializing = true;
+    const int result = init(&API, reinterpret_cast<GamePluginContext*>(&module));
+    module.initializing = false;
+    if (result != 0) {
+        log.error("插件初始化失败: ", path, "（返回值", std::to_string(result), "）");
+        modules.pop_back();
+        dlclose(handle);
+        return false;
+    }
+    commit(module);
+    log.info("已加载插件: ", path);
+    return true;
+#endif
+}
+
+int PluginHost::loadDirectory(const std::string& directory) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (!fs::is_directory(directory, ec)) return 0;
+
+    std::vector<std::string> paths;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        if (entry.is_regular_file(ec) && entry.path().extension() == ".so") paths.push_back(entry.path().string());
+    }
+    std::sort(paths.begin(), paths.end());
+
+    int loaded = 0;
+    for (const auto& path : paths) loaded += load(path) ? 1 : 0;
+    return loaded;
+}
+
+std::vector<std::string> PluginHost::loadedPaths() const {
+    std::vector<std::string> paths;
+    for (const Module& module : modules) paths.push_back(module.path);
+    return paths;
+}
+
+void PluginHost::commit(Module& module) {
+    for (auto& [name, command] : module.commands) {
+        CommandParser::addCommand(name, std::make_unique<PluginCommand>(name, command.fn, command.userData));
+    }
+    for (auto& [name, predicate] : module.predicates) predicates.emplace(name, predicate);
+    // 已编译的条件中同名的词可能需要按谓词重新解析
+    if (!module.predicates.empty()) ConditionEvaluator::clearCache();
+    for (auto& [event, handler] : module.handlers) handlers[event].push_back(handler);
+    module.commands.clear();
+    module.predicates.clear();
+    module.handlers.clear();
+}
+
+void PluginHost::dispatchSlow(GameEngine& engine, GamePluginEvent event, const std::string& subject) const {
+    for (const EventHandler& handler : handlers[event]) {
+        handler.fn(toHandle(engine), event, subject.c_str(), handler.userData);
+    }
+}
+
+std::optional<bool> PluginHost::evaluatePredicate(GameEngine& engine, const std::vector<std::string>& parts) const {
+    if (predicates.empty() || parts.empty()) return std::nullopt;
+    auto it = predicates.find(parts[0]);
+    if (it == predicates.end()) return std::nullopt;
+    const Predicate& predicate = it->second;
+    return withArgv(parts, [&](int argc, const char** argv) {
+        return predicate.fn(toHandle(engine), argc, argv, predicate.userData) != 0;
+    });
+}
+
+PluginHost::~PluginHost() {
+    // 只通知插件退出，不卸载（CommandParser中可能仍持有插件命令）
+    for (auto it = modules.rbegin(); it != modules.rend(); ++it) {
+        if (it->shutdown) it->shutdown();
+    }
+}
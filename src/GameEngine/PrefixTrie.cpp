@@ -0,0 +1,113 @@
+// src/GameEngine/PrefixTrie.cpp
+#include "PrefixTrie.h"
+#include <algorithm>
+
+namespace {
+// 在有序子节点中查找字节
+template<typename Children>
+auto findChild(Children& children, unsigned char c) {
+    auto it = std::lower_bound(children.begin(), children.end(), c,
+                               [](const auto& child, unsigned char value) { return child.first < value; });
+    return it != children.end() && it->first == c ? it : children.end();
+}
+}
+
+void PrefixTrie::insert(std::string_view word) {
+    // 先确认是否为新词，再沿路径更新子树计数
+    const bool added = !contains(word);
+    std::size_t node = 0;
+    if (added) ++nodes[0].words;
+    for (char ch : word) {
+        const auto c = static_cast<unsigned char>(ch);
+        auto& children = nodes[node].children;
+        auto it = std::lower_bound(children.begin(), children.end(), c,
+                                   [](const auto& child, unsigned char value) { return child.first < value; });
+        if (it == children.end() || it->first != c) {
+            const auto child = static_cast<std::uint32_t>(nodes.size());
+            children.insert(it, {c, child});
+            nodes.emplace_back(); // 可能使children失效，之后不再使用
+            node = child;
+        } else {
+            node = it->second;
+        }
+        if (added) ++nodes[node].words;
+    }
+    ++nodes[node].count;
+}
+
+void PrefixTrie::erase(std::string_view word) {
+    const std::size_t end = find(word);
+    if (end == nodes.size() || nodes[end].count == 0) return;
+    if (--nodes[end].count > 0) return;
+
+    // 沿路径减少子树计数，在第一个变空的子树处断开
+    std::size_t node = 0;
+    --nodes[0].words;
+    for (char ch : word) {
+        auto& children = nodes[node].children;
+        auto it = findChild(children, static_cast<unsigned char>(ch));
+        const std::size_t child = it->second;
+        if (--nodes[child].words == 0) {
+            deadNodes += subtreeSize(child);
+            children.erase(it);
+            break;
+        }
+        node = child;
+    }
+    if (deadNodes > nodes.size() / 2) rebuild();
+}
+
+bool PrefixTrie::contains(std::string_view word) const {
+    const std::size_t node = find(word);
+    return node != nodes.size() && nodes[node].count > 0;
+}
+
+std::vector<std::string> PrefixTrie::complete(std::string_view prefix, std::size_t limit) const {
+    std::vector<std::string> out;
+    const std::size_t node = find(prefix);
+    if (node == nodes.size() || limit == 0) return out;
+    std::string word(prefix);
+    collect(node, word, limit, out);
+    return out;
+}
+
+std::size_t PrefixTrie::find(std::string_view prefix) const {
+    std::size_t node = 0;
+    for (char ch : prefix) {
+        const auto& children = nodes[node].children;
+        auto it = findChild(children, static_cast<unsigned char>(ch));
+        if (it == children.end()) return nodes.size();
+        node = it->second;
+    }
+    return node;
+}
+
+void PrefixTrie::collect(std::size_t node, std::string& word, std::size_t limit, std::vector<std::string>& out) const {
+    if (nodes[node].count > 0) out.push_back(word);
+    for (const auto& [c, child] : nodes[node].children) {
+        if (out.size() >= limit) return;
+        word.push_back(static_cast<char>(c));
+        collect(child, word, limit, out);
+        word.pop_back();
+    }
+}
+
+std::size_t PrefixTrie::subtreeSize(std::size_t node) const {
+    std::size_t total = 1;
+    for (const auto& child : nodes[node].children) total += subtreeSize(child.second);
+    return total;
+}
+
+void PrefixTrie::rebuild() {
+    // 按计数重新插入所有词，回收断开的节点
+    std::vector<std::pair<std::string, std::uint32_t>> entries;
+    for (auto& word : complete("")) {
+        const std::uint32_t count = nodes[find(word)].count;
+        entries.emplace_back(std::move(word), count);
+    }
+    nodes.assign(1, Node());
+    deadNodes = 0;
+    for (const auto& [word, count] : entries) {
+        for (std::uint32_t i = 0; i < count; ++i) insert(word);
+    }
+}
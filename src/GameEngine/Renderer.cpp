@@ -5,17 +5,15 @@
 #include <sstream>
 #include <string>
 
-Renderer::Renderer() {
-    initScreen();
-}
+Renderer::Renderer() {}
 
 Renderer::~Renderer() {
-    endwin();
+    if (screenActive) endwin();
 }
 
 void Renderer::initScreen() {
+    screenActive = true;
     initscr();
-    setlocale(LC_ALL, "");
     use_default_colors();
     start_color();
     init_pair(COLOR_PAIR_DEFAULT, COLOR_WHITE, COLOR_BLACK);
@@ -90,7 +88,8 @@ void Renderer::drawBorder(int startX, int startY) {
 
 void Renderer::drawMapContent(const GameEngine& engine, int mapStartX, int mapStartY) {
     const GameMap& currentMap = engine.getCurrentMap();
-    
+    const auto& objects = currentMap.getAllObjects();
+
     // 只绘制视口内的地图内容
     for (int relY = 0; relY < viewportH; relY++) {
         for (int relX = 0; relX < viewportW; relX++) {
@@ -102,16 +101,42 @@ void Renderer::drawMapContent(const GameEngine& engine, int mapStartX, int mapSt
                 mapY < 0 || mapY >= currentMap.getHeight()) {
                 continue;
             }
-            
-            GameObject obj = currentMap.getObject(mapX, mapY);
-            if (obj.display != L' ') {
-                wchar_t wstr[2] = { obj.display, L'\0' };
-                mvwaddwstr(stdscr, mapStartY + relY, mapStartX + relX, wstr);
+
+            auto it = objects.find({mapX, mapY});
+            if (it == objects.end() || it->second.display == ' ') continue;
+
+            // 直接输出缓存的字符单元
+            const Cell& cell = cellOf(it->second.display);
+            mvwadd_wch(stdscr, mapStartY + relY, mapStartX + relX, &cell.cell);
+
+            // 宽字形占用右侧空格子，右侧有对象时由其覆盖
+            if (cell.width > 1 && !currentMap.hasObject(mapX + 1, mapY)) {
+                relX += cell.width - 1;
             }
         }
     }
 }
 
+const Renderer::Cell& Renderer::cellOf(GlyphId id) {
+    if (id >= cells.size()) cells.resize(id + 1);
+    Cell& cell = cells[id];
+    if (cell.width != 0) return cell;
+
+    const Glyph& glyph = GlyphTable::get(id);
+    wchar_t wch[CCHARW_MAX + 1] = {};
+    std::size_t n = 0;
+    for (char32_t cp : glyph.codepoints) {
+        if (n < CCHARW_MAX) wch[n++] = static_cast<wchar_t>(cp);
+    }
+    cell.width = glyph.width;
+    if (setcchar(&cell.cell, wch, A_NORMAL, 0, nullptr) == ERR) {
+        const wchar_t fallback[] = {L'?', L'\0'};
+        setcchar(&cell.cell, fallback, A_NORMAL, 0, nullptr);
+        cell.width = 1;
+    }
+    return cell;
+}
+
 void Renderer::drawPlayer(const GameEngine& engine, int mapStartX, int mapStartY) {
     wchar_t playerChar = L' ';
     switch(engine.getPlayerDir()) {
@@ -138,6 +163,10 @@ void Renderer::drawUI(const GameEngine& engine) {
         drawInventory(engine.getInventory(), 
                       engine.getInventoryManager().getSelectedIndex());
     }
+
+    if (engine.getGameState() == GameState::CONSOLE) {
+        drawConsole(engine.getConsole());
+    }
 }
 
 void Renderer::drawDialog(const Dialog& dialog) {
@@ -176,6 +205,57 @@ void Renderer::drawDialog(const Dialog& dialog) {
     }
 }
 
+void Renderer::drawConsole(const Console& console) {
+    const int consoleWidth = termWidth - 2;
+    const int consoleHeight = std::max(4, termHeight / 2);
+    const int startX = 1;
+    const int startY = termHeight - consoleHeight - 1;
+    if (startY < 0 || consoleWidth < 4) return;
+
+    // 清空区域并绘制边框
+    attron(COLOR_PAIR(COLOR_PAIR_DEFAULT));
+    for (int y = startY + 1; y < startY + consoleHeight; y++) {
+        mvhline(y, startX + 1, ' ', consoleWidth - 1);
+    }
+    mvaddch(startY, startX, ACS_ULCORNER);
+    mvaddch(startY, startX + consoleWidth, ACS_URCORNER);
+    mvaddch(startY + consoleHeight, startX, ACS_LLCORNER);
+    mvaddch(startY + consoleHeight, startX + consoleWidth, ACS_LRCORNER);
+    for (int x = startX + 1; x < startX + consoleWidth; x++) {
+        mvaddch(startY, x, ACS_HLINE);
+        mvaddch(startY + consoleHeight, x, ACS_HLINE);
+    }
+    for (int y = startY + 1; y < startY + consoleHeight; y++) {
+        mvaddch(y, startX, ACS_VLINE);
+        mvaddch(y, startX + consoleWidth, ACS_VLINE);
+    }
+
+    attron(COLOR_PAIR(COLOR_PAIR_HIGHLIGHT) | A_BOLD);
+    mvprintw(startY, startX + 2, "%s", "【 控制台 】");
+    attroff(COLOR_PAIR(COLOR_PAIR_HIGHLIGHT) | A_BOLD);
+
+    // 最近的输出（最后一行留给输入）
+    const auto& output = console.getOutput();
+    const int rows = consoleHeight - 2;
+    const std::size_t shown = std::min<std::size_t>(output.size(), rows);
+    for (std::size_t i = 0; i < shown; ++i) {
+        const std::string& line = output[output.size() - shown + i];
+        mvaddnstr(startY + 1 + i, startX + 2, line.c_str(), static_cast<int>(line.size()));
+    }
+
+    // 输入行（过长时显示末尾）
+    std::string input = "> " + console.getInput();
+    const std::size_t maxBytes = static_cast<std::size_t>(consoleWidth - 4);
+    if (input.size() > maxBytes) {
+        std::size_t cut = input.size() - maxBytes;
+        while (cut < input.size() && (static_cast<unsigned char>(input[cut]) & 0xC0) == 0x80) ++cut;
+        input.erase(0, cut);
+    }
+    attron(A_BOLD);
+    mvprintw(startY + consoleHeight - 1, startX + 2, "%s_", input.c_str());
+    attroff(A_BOLD);
+}
+
 void Renderer::drawInventory(const std::list<GameObject>& inventory, int selectedIndex) {
     const int invWidth = std::min(termWidth - 2, 20);
     const int invHeight = std::min(termHeight - 2, 25);
@@ -2,10 +2,22 @@
 #include "SaveLoadManager.h"
 #include "GameEngine.h"
 #include "Log.h"
+#include <iterator>
 #include <regex>
+#include <sstream>
 
 using namespace std;
 
+namespace {
+
+// 存档字段已自行转义，只按空白分隔（不走脚本词法的引号和转义规则）
+vector<string> splitFields(const string& line) {
+    istringstream iss(line);
+    return {istream_iterator<string>{iss}, istream_iterator<string>{}};
+}
+
+} // namespace
+
 void SaveLoadManager::saveState(const GameEngine& engine, const std::string& filename) {
     ofstream file(filename, ios::trunc);
     if (!file.is_open()) {
@@ -73,7 +85,7 @@ void SaveLoadManager::loadState(GameEngine& engine, const std::string& filename)
         engine.getVariables().clear();
         engine.getVisitedMarkers().clear();
         engine.getInventoryManager().clear();
-        engine.getMaps().clear();
+        engine.clearMaps();
 
         string line;
         while (getline(file, line)) {
@@ -89,7 +101,7 @@ void SaveLoadManager::loadState(GameEngine& engine, const std::string& filename)
                     line.erase(0, line.find_first_not_of(" \t"));
                     if (line == "}") break;
 
-                    vector<string> tokens = engine.tokenize(line);
+                    vector<string> tokens = splitFields(line);
                     if (tokens.empty()) continue;
 
                     if (tokens[0] == "player") {
@@ -109,13 +121,13 @@ void SaveLoadManager::loadState(GameEngine& engine, const std::string& filename)
                     }
                     else if (tokens[0] == "map") {
                         string mapName = unescapeString(tokens[1]);
-                        GameMap& newMap = engine.getMaps()[mapName];
+                        GameMap& newMap = engine.getLoadedMaps()[mapName];
                         
                         while (getline(file, line)) {
                             line.erase(0, line.find_first_not_of(" \t"));
                             if (line == "}") break;
                             
-                            vector<string> objTokens = engine.tokenize(line);
+                            vector<string> objTokens = splitFields(line);
                             if (objTokens[0] == "object") {
                                 int x = stoi(objTokens[1]);
                                 int y = stoi(objTokens[2]);
@@ -136,7 +148,7 @@ void SaveLoadManager::loadState(GameEngine& engine, const std::string& filename)
 void SaveLoadManager::serializeGameObject(ostream& os, const GameObject& obj) {
     os << escapeString(obj.name) << " " 
        << escapeString(obj.type) << " "
-       << obj.display << " "
+       << escapeString(obj.getDisplayText()) << " "
        << obj.x << " " << obj.y << " ";
 
     // 序列化属性
@@ -151,14 +163,13 @@ void SaveLoadManager::serializeGameObject(ostream& os, const GameObject& obj) {
 
 GameObject SaveLoadManager::deserializeGameObject(istream& is) {
     GameObject obj;
-    string name, type;
-    char display;
+    string name, type, display;
     int x, y;
     
     is >> name >> type >> display >> x >> y;
     obj.name = unescapeString(name);
     obj.type = unescapeString(type);
-    obj.display = display;
+    obj.setDisplay(unescapeString(display));
     obj.x = x;
     obj.y = y;
 
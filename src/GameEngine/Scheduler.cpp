@@ -0,0 +1,151 @@
+// src/GameEngine/Scheduler.cpp
+#include "Scheduler.h"
+#include <algorithm>
+
+Scheduler::Scheduler() : nodes(SENTINELS) {
+    for (std::uint32_t i = 0; i < SENTINELS; ++i) nodes[i].prev = nodes[i].next = i;
+}
+
+void Scheduler::schedule(const std::string& name, std::uint32_t delay, std::uint32_t interval, CompiledCommand command) {
+    cancel(name);
+
+    const std::uint32_t index = acquire();
+    Node& node = nodes[index];
+    node.sequence = nextSequence++;
+    node.expires = tick + std::max<std::uint32_t>(delay, 1);
+    node.interval = interval;
+    node.name = name;
+    node.command = std::make_shared<const CompiledCommand>(std::move(command));
+    byName[name] = index;
+    link(index);
+}
+
+bool Scheduler::cancel(const std::string& name) {
+    auto it = byName.find(name);
+    if (it == byName.end()) return false;
+    release(it->second);
+    return true;
+}
+
+std::optional<Scheduler::Timer> Scheduler::find(const std::string& name) const {
+    auto it = byName.find(name);
+    if (it == byName.end()) return std::nullopt;
+    const Node& node = nodes[it->second];
+    return Timer{node.expires, node.interval, node.sequence, node.command};
+}
+
+void Scheduler::restore(const std::string& name, const std::optional<Timer>& timer) {
+    cancel(name);
+    if (!timer) return;
+
+    const std::uint32_t index = acquire();
+    Node& node = nodes[index];
+    node.sequence = timer->sequence;
+    node.expires = std::max(timer->expires, tick + 1); // 已过的回合不再回到过去的槽
+    node.interval = timer->interval;
+    node.name = name;
+    node.command = timer->command;
+    byName[name] = index;
+    link(index);
+}
+
+void Scheduler::advance(const std::function<void(const CompiledCommand&)>& run) {
+    ++tick;
+    const std::uint32_t slot = tick & (SLOTS - 1);
+    // 第0层转满一圈时逐层下移，直到某层未转满
+    if (slot == 0) {
+        for (int level = 1; level < LEVELS; ++level) {
+            cascade(level);
+            if (((tick >> (LEVEL_BITS * level)) & (SLOTS - 1)) != 0) break;
+        }
+    }
+
+    // 取出本回合到期的定时器，按添加顺序执行
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> due;
+    for (std::uint32_t i = nodes[slot].next; i != slot; i = nodes[i].next) due.emplace_back(nodes[i].sequence, i);
+    for (const auto& [sequence, index] : due) nodes[index].prev = nodes[index].next = index;
+    nodes[slot].prev = nodes[slot].next = slot;
+    std::sort(due.begin(), due.end());
+
+    for (const auto& [sequence, index] : due) {
+        if (nodes[index].sequence != sequence) continue; // 已被之前执行的命令取消
+        std::shared_ptr<const CompiledCommand> command = nodes[index].command;
+        run(*command);
+
+        // 执行期间可能添加了定时器，需重新取结点
+        Node& node = nodes[index];
+        if (node.sequence != sequence) continue;
+        if (node.interval > 0) {
+            node.expires = tick + node.interval;
+            link(index);
+        } else {
+            release(index);
+        }
+    }
+}
+
+std::vector<Scheduler::TimerInfo> Scheduler::list() const {
+    std::vector<std::pair<std::uint64_t, TimerInfo>> timers;
+    for (const auto& [name, index] : byName) {
+        const Node& node = nodes[index];
+        timers.push_back({node.sequence, {name, node.expires - tick, node.interval, node.command.get()}});
+    }
+    std::sort(timers.begin(), timers.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<TimerInfo> result;
+    result.reserve(timers.size());
+    for (auto& [sequence, info] : timers) result.push_back(std::move(info));
+    return result;
+}
+
+std::uint32_t Scheduler::acquire() {
+    if (!freeNodes.empty()) {
+        const std::uint32_t index = freeNodes.back();
+        freeNodes.pop_back();
+        return index;
+    }
+    nodes.emplace_back();
+    return static_cast<std::uint32_t>(nodes.size() - 1);
+}
+
+void Scheduler::link(std::uint32_t index) {
+    Node& node = nodes[index];
+    const std::uint64_t delta = node.expires - tick;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (std::uint64_t{1} << (LEVEL_BITS * (level + 1)))) ++level;
+    const std::uint32_t head = level * SLOTS + ((node.expires >> (LEVEL_BITS * level)) & (SLOTS - 1));
+
+    // 追加到槽的末尾
+    node.prev = nodes[head].prev;
+    node.next = head;
+    nodes[node.prev].next = index;
+    nodes[head].prev = index;
+}
+
+void Scheduler::unlink(std::uint32_t index) {
+    Node& node = nodes[index];
+    nodes[node.prev].next = node.next;
+    nodes[node.next].prev = node.prev;
+    node.prev = node.next = index;
+}
+
+void Scheduler::release(std::uint32_t index) {
+    unlink(index);
+    Node& node = nodes[index];
+    byName.erase(node.name);
+    node.sequence = 0;
+    node.name.clear();
+    node.command.reset();
+    freeNodes.push_back(index);
+}
+
+void Scheduler::cascade(int level) {
+    const std::uint32_t head = level * SLOTS + ((tick >> (LEVEL_BITS * level)) & (SLOTS - 1));
+    std::uint32_t i = nodes[head].next;
+    nodes[head].prev = nodes[head].next = head;
+    while (i != head) {
+        const std::uint32_t next = nodes[i].next;
+        link(i);
+        i = next;
+    }
+}
@@ -0,0 +1,70 @@
+// src/GameEngine/Scoreboard.cpp
+#include "Scoreboard.h"
+#include "GameMap.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// 对选中的列元素执行同一运算
+template<typename Op>
+void applyTo(std::vector<int>& column, const std::vector<Scoreboard::EntityId>& ids, Op op) {
+    for (Scoreboard::EntityId id : ids) {
+        column[id] = op(column[id]);
+    }
+}
+
+} // namespace
+
+void Scoreboard::addObjective(const std::string& name, int defaultValue) {
+    // 与 /scoreboard add 一致，重复创建会重置整列
+    objectives[name] = Objective{defaultValue, {}};
+}
+
+int Scoreboard::get(const std::string& name, EntityId id) const {
+    auto it = objectives.find(name);
+    if (it == objectives.end()) throw std::runtime_error("未定义的计分项: " + name);
+    const Objective& objective = it->second;
+    return id != 0 && id < objective.values.size() ? objective.values[id] : objective.defaultValue;
+}
+
+Scoreboard::EntityId Scoreboard::track(GameObject& entity) {
+    if (entity.entityId != 0) return entity.entityId;
+    entity.entityId = GameMap::acquireEntityId();
+    for (auto& [name, objective] : objectives) {
+        if (entity.entityId < objective.values.size()) objective.values[entity.entityId] = objective.defaultValue;
+    }
+    return entity.entityId;
+}
+
+void Scoreboard::apply(const std::string& name, const std::string& op, const std::vector<EntityId>& ids, int value) {
+    Objective& objective = require(name);
+    if (ids.empty()) return;
+
+    EntityId maxId = *std::max_element(ids.begin(), ids.end());
+    if (maxId >= objective.values.size()) {
+        objective.values.resize(maxId + 1, objective.defaultValue);
+    }
+
+    auto& column = objective.values;
+    if (op == "=") {
+        applyTo(column, ids, [value](int) { return value; });
+    } else if (op == "+=") {
+        applyTo(column, ids, [value](int v) { return v + value; });
+    } else if (op == "-=") {
+        applyTo(column, ids, [value](int v) { return v - value; });
+    } else if (op == "*=") {
+        applyTo(column, ids, [value](int v) { return v * value; });
+    } else if (op == "/=") {
+        if (value == 0) throw std::runtime_error("除数不能为零");
+        applyTo(column, ids, [value](int v) { return v / value; });
+    } else {
+        throw std::runtime_error("未知操作符: " + op);
+    }
+}
+
+Scoreboard::Objective& Scoreboard::require(const std::string& name) {
+    auto it = objectives.find(name);
+    if (it == objectives.end()) throw std::runtime_error("未定义的计分项: " + name);
+    return it->second;
+}
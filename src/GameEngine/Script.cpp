@@ -0,0 +1,462 @@
+// src/GameEngine/Script.cpp
+#include "Script.h"
+#include "CommandParser.h"
+#include "MappedFile.h"
+#include "ScriptLexer.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+/// 小于该大小的脚本直接单线程编译，避免线程启动开销
+constexpr std::size_t PARALLEL_THRESHOLD = 64 * 1024;
+
+// 去除行注释和首尾空白（只调整视图，不复制）
+std::string_view cleanLine(std::string_view line) {
+    line = ScriptLexer::stripComment(line);
+
+    size_t begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos) return {};
+    size_t end = line.find_last_not_of(" \t\r");
+    return line.substr(begin, end - begin + 1);
+}
+
+// 逐行读取源文本，行号从1开始
+struct LineCursor {
+    std::string_view source;
+    size_t pos = 0;
+    int lineNumber = 0;
+
+    bool next(std::string_view& line) {
+        if (pos >= source.size()) return false;
+        size_t end = source.find('\n', pos);
+        if (end == std::string_view::npos) end = source.size();
+        line = cleanLine(source.substr(pos, end - pos));
+        pos = end + 1;
+        lineNumber++;
+        return true;
+    }
+};
+
+// 去除块声明末尾的 "{" 和首尾空白
+std::string_view stripOpenBrace(std::string_view header) {
+    if (!header.empty() && header.back() == '{') header.remove_suffix(1);
+    return cleanLine(header);
+}
+
+// 解析物品效果块声明，支持 "item 使用效果 物品名:" 与 "item 使用效果:物品名"
+std::string parseItemName(std::string_view headerLine, int line) {
+    std::string_view rest = stripOpenBrace(headerLine.substr(std::string_view("item 使用效果").size()));
+    if (!rest.empty() && rest.front() == ':') rest.remove_prefix(1);
+    else if (!rest.empty() && rest.back() == ':') rest.remove_suffix(1);
+    else throw ScriptError(line, "Invalid item effect format: " + std::string(headerLine));
+
+    rest = cleanLine(rest);
+    if (rest.empty() || rest.find_first_of(" \t") != std::string_view::npos)
+        throw ScriptError(line, "Invalid item effect format: " + std::string(headerLine));
+    return std::string(rest);
+}
+
+// 块内容在源文本中的位置
+struct BlockBody {
+    std::string_view text; ///< 块内容（不含声明行和闭合行）
+    int firstLine = 0;     ///< 块内容首行行号
+};
+
+// 块内开启嵌套的行：单独的 "{" 或 for 循环声明
+bool opensBlock(std::string_view line) {
+    return line == "{" || (line.substr(0, 4) == "for " && line.back() == '{');
+}
+
+// 从声明行之后读取块内容，直到匹配的 "}"（光标停在闭合行之后）
+bool readBody(LineCursor& cursor, BlockBody& body) {
+    body.firstLine = cursor.lineNumber + 1;
+    size_t bodyBegin = cursor.pos;
+    int blockDepth = 1;
+    std::string_view line;
+    while (true) {
+        size_t lineBegin = cursor.pos;
+        if (!cursor.next(line)) return false;
+        if (opensBlock(line)) blockDepth++;
+        else if (line == "}" && --blockDepth == 0) {
+            body.text = cursor.source.substr(bodyBegin, lineBegin - bodyBegin);
+            return true;
+        }
+    }
+}
+
+bool isIdentifierChar(char c) {
+    unsigned char u = static_cast<unsigned char>(c);
+    return std::isalnum(u) || c == '_' || u >= 0x80; // 允许中文标识符
+}
+
+// 宏定义：macro 名称(参数, ...) { ... }
+struct Macro {
+    std::vector<std::string> params;
+    BlockBody body;
+};
+
+using MacroTable = std::unordered_map<std::string, Macro>;
+
+// 按顶层逗号拆分参数（引号和括号内的逗号不拆分）
+std::vector<std::string> splitArgs(std::string_view text) {
+    std::vector<std::string> args;
+    if (cleanLine(text).empty()) return args;
+
+    int parens = 0;
+    bool quoted = false;
+    size_t start = 0;
+    for (size_t i = 0; i <= text.size(); ++i) {
+        char c = i < text.size() ? text[i] : ',';
+        if (c == '"' && (i == 0 || text[i - 1] != '\\')) quoted = !quoted;
+        else if (quoted) continue;
+        else if (c == '(' || c == '{') parens++;
+        else if (c == ')' || c == '}') parens--;
+        else if (c == ',' && parens == 0) {
+            args.emplace_back(cleanLine(text.substr(start, i - start)));
+            start = i + 1;
+        }
+    }
+    return args;
+}
+
+// 解析宏声明行
+std::pair<std::string, Macro> parseMacroHeader(std::string_view line, int lineNumber) {
+    std::string_view rest = stripOpenBrace(line.substr(std::string_view("macro").size()));
+    size_t open = rest.find('(');
+    if (open == std::string_view::npos || rest.back() != ')')
+        throw ScriptError(lineNumber, "宏声明格式错误: " + std::string(line));
+
+    std::string name(cleanLine(rest.substr(0, open)));
+    if (name.empty() || !std::all_of(name.begin(), name.end(), isIdentifierChar))
+        throw ScriptError(lineNumber, "宏名称无效: " + std::string(line));
+
+    Macro macro;
+    macro.params = splitArgs(rest.substr(open + 1, rest.size() - open - 2));
+    for (const auto& param : macro.params) {
+        if (param.empty() || !std::all_of(param.begin(), param.end(), isIdentifierChar))
+            throw ScriptError(lineNumber, "宏参数名称无效: " + param);
+    }
+    return {std::move(name), std::move(macro)};
+}
+
+/**
+ * 块内容展开器：在编译期展开for循环与宏调用，并替换变量
+ *
+ * - $名称 替换为当前作用域中的变量值（未定义的名称原样保留，如 display=$）
+ * - ${表达式} 计算整数表达式，支持 + - * / % 和括号
+ * - for 变量 in 起始..结束 [step 步长] { ... } 包含两端
+ * - 宏名(参数, ...) 展开宏体，宏体中的命令使用调用处的行号
+ */
+class Expander {
+public:
+    Expander(const MacroTable& macros, ScriptBlock& block) : macros(macros), block(block) {}
+
+    // 展开一段块内容；callLine非0时所有命令记为该行
+    void expand(const BlockBody& body, int callLine) {
+        LineCursor cursor{body.text, 0, body.firstLine - 1};
+        int blockDepth = 1;
+        std::string_view line;
+        while (cursor.next(line)) {
+            if (line.empty()) continue;
+            const int lineNumber = callLine ? callLine : cursor.lineNumber;
+            // if块只执行第一层命令
+            const bool active = block.kind != ScriptBlock::Kind::IF || blockDepth == 1;
+
+            if (line.substr(0, 4) == "for " && line.back() == '{') {
+                BlockBody loopBody;
+                if (!readBody(cursor, loopBody)) throw ScriptError(lineNumber, "for块未闭合");
+                if (active) expandFor(line, loopBody, callLine, lineNumber);
+            } else if (line == "{") {
+                blockDepth++;
+            } else if (line == "}") {
+                blockDepth--;
+            } else if (active) {
+                if (line.front() != '/' && line.back() == ')') expandCall(line, lineNumber);
+                else emit(line, lineNumber);
+            }
+        }
+    }
+
+private:
+    static constexpr int MAX_MACRO_DEPTH = 64;           ///< 宏嵌套调用上限（防止递归）
+    static constexpr size_t MAX_EXPANDED_LINES = 1 << 20; ///< 单个块展开后的命令数上限
+
+    const MacroTable& macros;
+    ScriptBlock& block;
+    std::vector<std::pair<std::string, std::string>> scope; ///< 变量栈，后定义的优先
+    int macroDepth = 0;
+
+    const std::string* lookup(std::string_view name) const {
+        for (auto it = scope.rbegin(); it != scope.rend(); ++it) {
+            if (it->first == name) return &it->second;
+        }
+        return nullptr;
+    }
+
+    void emit(std::string_view line, int lineNumber) {
+        if (block.lines.size() >= MAX_EXPANDED_LINES) throw ScriptError(lineNumber, "展开后的命令过多");
+        if (line.find('$') == std::string_view::npos) block.lines.emplace_back(line);
+        else block.lines.push_back(substitute(line, lineNumber));
+        block.commands.push_back(CommandParser::compile(block.lines.back(), lineNumber));
+    }
+
+    // 替换 $名称 与 ${表达式}
+    std::string substitute(std::string_view text, int lineNumber) const {
+        std::string result;
+        result.reserve(text.size());
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] != '$' || i + 1 >= text.size()) {
+                result += text[i];
+            } else if (text[i + 1] == '{') {
+                size_t close = text.find('}', i + 2);
+                if (close == std::string_view::npos) throw ScriptError(lineNumber, "${ 未闭合: " + std::string(text));
+                result += std::to_string(evaluate(text.substr(i + 2, close - i - 2), lineNumber));
+                i = close;
+            } else {
+                size_t end = i + 1;
+                while (end < text.size() && isIdentifierChar(text[end])) end++;
+                const std::string* value = lookup(text.substr(i + 1, end - i - 1));
+                if (!value) {
+                    result += text[i];
+                    continue;
+                }
+                result += *value;
+                i = end - 1;
+            }
+        }
+        return result;
+    }
+
+    // 整数表达式求值（递归下降）
+    long long evaluate(std::string_view expr, int lineNumber) const {
+        ExpressionParser parser{this, expr, 0, lineNumber};
+        long long value = parser.sum();
+        parser.skipSpace();
+        if (parser.pos != expr.size()) parser.fail();
+        return value;
+    }
+
+    struct ExpressionParser {
+        const Expander* owner;
+        std::string_view text;
+        size_t pos;
+        int lineNumber;
+
+        [[noreturn]] void fail() const {
+            throw ScriptError(lineNumber, "表达式无效: " + std::string(text));
+        }
+
+        void skipSpace() {
+            while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) pos++;
+        }
+
+        bool accept(char c) {
+            skipSpace();
+            if (pos < text.size() && text[pos] == c) {
+                pos++;
+                return true;
+            }
+            return false;
+        }
+
+        long long sum() {
+            long long value = product();
+            while (true) {
+                if (accept('+')) value += product();
+                else if (accept('-')) value -= product();
+                else return value;
+            }
+        }
+
+        long long product() {
+            long long value = factor();
+            while (true) {
+                if (accept('*')) value *= factor();
+                else if (accept('/') || accept('%')) {
+                    bool divide = text[pos - 1] == '/';
+                    long long rhs = factor();
+                    if (rhs == 0) throw ScriptError(lineNumber, "表达式除数为零: " + std::string(text));
+                    value = divide ? value / rhs : value % rhs;
+                } else return value;
+            }
+        }
+
+        long long factor() {
+            if (accept('-')) return -factor();
+            if (accept('(')) {
+                long long value = sum();
+                if (!accept(')')) fail();
+                return value;
+            }
+            skipSpace();
+            size_t start = pos;
+            while (pos < text.size() && isIdentifierChar(text[pos])) pos++;
+            if (start == pos) fail();
+
+            std::string_view token = text.substr(start, pos - start);
+            if (const std::string* value = owner->lookup(token)) return number(*value);
+            return number(token);
+        }
+
+        long long number(std::string_view token) const {
+            long long value = 0;
+            auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+            if (ec != std::errc() || ptr != token.data() + token.size()) {
+                throw ScriptError(lineNumber, "表达式中的值不是整数: " + std::string(token));
+            }
+            return value;
+        }
+    };
+
+    // for 变量 in 起始..结束 [step 步长] {
+    void expandFor(std::string_view header, const BlockBody& body, int callLine, int lineNumber) {
+        std::string_view rest = stripOpenBrace(header.substr(4));
+        size_t in = rest.find(" in ");
+        size_t range = rest.find("..");
+        if (in == std::string_view::npos || range == std::string_view::npos || range < in)
+            throw ScriptError(lineNumber, "for格式错误: " + std::string(header));
+
+        std::string var(cleanLine(rest.substr(0, in)));
+        if (var.empty() || !std::all_of(var.begin(), var.end(), isIdentifierChar))
+            throw ScriptError(lineNumber, "for变量名称无效: " + std::string(header));
+
+        std::string_view endText = rest.substr(range + 2);
+        long long step = 1;
+        size_t stepPos = endText.find(" step ");
+        if (stepPos != std::string_view::npos) {
+            step = evaluate(endText.substr(stepPos + 6), lineNumber);
+            endText = endText.substr(0, stepPos);
+        }
+        long long first = evaluate(rest.substr(in + 4, range - in - 4), lineNumber);
+        long long last = evaluate(endText, lineNumber);
+        if (step <= 0) throw ScriptError(lineNumber, "for步长必须为正: " + std::string(header));
+
+        // 结束小于起始时倒序迭代
+        const long long direction = first <= last ? 1 : -1;
+        scope.emplace_back(std::move(var), std::string());
+        const size_t slot = scope.size() - 1;
+        for (long long i = first; direction > 0 ? i <= last : i >= last; i += direction * step) {
+            scope[slot].second = std::to_string(i);
+            expand(body, callLine);
+        }
+        scope.pop_back();
+    }
+
+    // 宏名(参数, ...)
+    void expandCall(std::string_view line, int lineNumber) {
+        size_t open = line.find('(');
+        std::string_view name = cleanLine(line.substr(0, open == std::string_view::npos ? 0 : open));
+        auto it = macros.find(std::string(name));
+        if (open == std::string_view::npos || it == macros.end())
+            throw ScriptError(lineNumber, "未定义的宏: " + std::string(line));
+
+        const Macro& macro = it->second;
+        std::vector<std::string> args = splitArgs(line.substr(open + 1, line.size() - open - 2));
+        if (args.size() != macro.params.size()) {
+            throw ScriptError(lineNumber, "宏" + std::string(name) + "需要" + std::to_string(macro.params.size()) +
+                                          "个参数，实际为" + std::to_string(args.size()));
+        }
+        if (macroDepth >= MAX_MACRO_DEPTH) throw ScriptError(lineNumber, "宏展开层数过多: " + std::string(name));
+
+        // 参数在调用处求值，宏体只能看到自己的参数
+        std::vector<std::pair<std::string, std::string>> bindings;
+        for (size_t i = 0; i < args.size(); ++i) {
+            bindings.emplace_back(macro.params[i], substitute(args[i], lineNumber));
+        }
+        std::swap(scope, bindings);
+        macroDepth++;
+        expand(macro.body, lineNumber);
+        macroDepth--;
+        std::swap(scope, bindings);
+    }
+};
+
+} // namespace
+
+Script Script::load(const std::string& filename) {
+    MappedFile file(filename);
+    return compile(file.view());
+}
+
+Script Script::compile(std::string_view source) {
+    Script script;
+    std::vector<BlockBody> bodies;
+
+    // 1. 扫描块边界：只维护嵌套深度，不分词；宏定义在此收集，供所有块展开
+    MacroTable macros;
+    LineCursor cursor{source};
+    std::string_view line;
+    while (cursor.next(line)) {
+        if (line.empty()) continue;
+
+        ScriptBlock block;
+        block.line = cursor.lineNumber;
+        std::pair<std::string, Macro> macro;
+        const bool isMacro = line.substr(0, 6) == "macro ";
+        if (isMacro) {
+            macro = parseMacroHeader(line, block.line);
+        } else if (line.substr(0, 4) == "init") {
+            block.kind = ScriptBlock::Kind::INIT;
+        } else if (line.substr(0, 3) == "if ") {
+            block.kind = ScriptBlock::Kind::IF;
+            block.header = std::string(stripOpenBrace(line.substr(3)));
+        } else if (line.substr(0, std::string_view("item 使用效果").size()) == "item 使用效果") {
+            block.kind = ScriptBlock::Kind::ITEM_EFFECT;
+            block.header = parseItemName(line, block.line);
+        } else {
+            throw ScriptError(block.line, "顶层命令必须在init/if/item/macro块内: " + std::string(line));
+        }
+
+        BlockBody body;
+        if (!readBody(cursor, body)) {
+            throw ScriptError(block.line, "块未闭合");
+        }
+        if (isMacro) {
+            macro.second.body = body;
+            if (!macros.emplace(std::move(macro)).second) {
+                throw ScriptError(block.line, "宏重复定义: " + std::string(line));
+            }
+            continue;
+        }
+        bodies.push_back(body);
+        script.blocks.push_back(std::move(block));
+    }
+
+    // 2. 分词各块（大脚本并行，块之间互不依赖）
+    const size_t blockCount = script.blocks.size();
+    size_t workerCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), blockCount);
+    if (source.size() < PARALLEL_THRESHOLD || workerCount < 2) {
+        for (size_t i = 0; i < blockCount; ++i) Expander(macros, script.blocks[i]).expand(bodies[i], 0);
+        return script;
+    }
+
+    std::atomic<size_t> nextBlock{0};
+    std::vector<std::exception_ptr> errors(blockCount);
+    auto worker = [&]() {
+        // 按块领取任务，块大小不均时也能保持负载均衡
+        for (size_t i = nextBlock++; i < blockCount; i = nextBlock++) {
+            try {
+                Expander(macros, script.blocks[i]).expand(bodies[i], 0);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < workerCount; ++i) workers.emplace_back(worker);
+    worker();
+    for (auto& t : workers) t.join();
+
+    // 3. 按源文件顺序报告第一个错误
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    return script;
+}
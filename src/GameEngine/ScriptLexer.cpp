@@ -0,0 +1,89 @@
+// src/GameEngine/ScriptLexer.cpp
+#include "ScriptLexer.h"
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+char unescape(char c) {
+    switch (c) {
+        case 'n': return '\n';
+        case 't': return '\t';
+        default:  return c;
+    }
+}
+
+} // namespace
+
+std::string ScriptToken::value() const {
+    if (plain) return std::string(raw);
+
+    std::string result;
+    result.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        char c = raw[i];
+        if (c == '"') continue;
+        if (c == '\\' && i + 1 < raw.size()) c = unescape(raw[++i]);
+        result += c;
+    }
+    return result;
+}
+
+bool ScriptLexer::next(ScriptToken& token) {
+    // 跳过空白和注释
+    while (pos < source.size()) {
+        if (isSpace(source[pos])) {
+            pos++;
+        } else if (source.compare(pos, 2, "//") == 0) {
+            size_t lineEnd = source.find('\n', pos);
+            pos = lineEnd == std::string_view::npos ? source.size() : lineEnd + 1;
+        } else {
+            break;
+        }
+    }
+    if (pos >= source.size()) return false;
+
+    size_t start = pos;
+    bool inQuotes = false;
+    token.plain = true;
+    while (pos < source.size()) {
+        char c = source[pos];
+        if (c == '\\' && pos + 1 < source.size()) {
+            token.plain = false;
+            pos += 2;
+            continue;
+        }
+        if (c == '"') {
+            token.plain = false;
+            inQuotes = !inQuotes;
+        } else if (!inQuotes && (isSpace(c) || source.compare(pos, 2, "//") == 0)) {
+            break;
+        }
+        pos++;
+    }
+    token.raw = source.substr(start, pos - start);
+    return true;
+}
+
+std::string_view ScriptLexer::stripComment(std::string_view line) {
+    bool inQuotes = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (c == '\\') i++;
+        else if (c == '"') inQuotes = !inQuotes;
+        else if (!inQuotes && c == '/' && i + 1 < line.size() && line[i + 1] == '/') return line.substr(0, i);
+    }
+    return line;
+}
+
+std::vector<std::string> ScriptLexer::split(std::string_view line) {
+    std::vector<std::string> tokens;
+    ScriptLexer lexer(line);
+    ScriptToken token;
+    while (lexer.next(token)) {
+        tokens.push_back(token.value());
+    }
+    return tokens;
+}
@@ -0,0 +1,218 @@
+// src/GameEngine/ScriptValidator.cpp
+#include "ScriptValidator.h"
+#include "Script.h"
+#include "MappedFile.h"
+#include "CommandHandler.h"
+#include "CommandUtils.h"
+#include "ConcreteCommands/MapCommand.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+constexpr int DEFAULT_MAP_SIZE = 20;
+
+// 整个脚本中出现过的定义
+struct Definitions {
+    std::set<std::string> items;
+    std::set<std::string> npcs;
+    std::map<std::string, std::pair<int, int>> maps; ///< 地图名 -> 宽高
+};
+
+bool parseSize(std::string_view text, int& value) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc() && ptr == text.data() + text.size() && value > 0;
+}
+
+class Checker {
+public:
+    explicit Checker(std::vector<Diagnostic>& diagnostics) : diagnostics(diagnostics) {}
+
+    // 第一遍：收集定义（不报告问题）
+    void collect(const CompiledCommand& command) {
+        const auto& args = command.args;
+        if (args.size() < 3) return;
+        if (args[0] == "/item" && args[1] == "define") defs.items.insert(args[2]);
+        else if (args[0] == "/npc" && args[1] == "create") defs.npcs.insert(args[2]);
+        else if (args[0] == "/map" && args[1] == "create") {
+            auto params = CommandUtils::parseNamedParams(args, 3);
+            int width = DEFAULT_MAP_SIZE, height = DEFAULT_MAP_SIZE;
+            if (auto text = params.find("width")) parseSize(*text, width);
+            if (auto text = params.find("height")) parseSize(*text, height);
+            defs.maps[args[2]] = {width, height};
+        }
+    }
+
+    // 第二遍：逐条检查命令
+    void check(const CompiledCommand& command) {
+        line = command.line;
+        const auto& args = command.args;
+        if (!command.handler) {
+            error("未知命令: " + args[0]);
+            return;
+        }
+
+        // 参数个数和格式按命令注册的参数模式检查（插件命令自行检查参数）
+        if (command.handler->getSubcommands().empty()) return;
+        if (!command.subcommand) {
+            if (args.size() < 2) error("缺少子命令: " + command.handler->getSubcommands().usage());
+            else error("未知子命令: " + args[0] + " " + args[1]);
+            return;
+        }
+        if (CommandStatus status = command.subcommand->check(args); !status) {
+            error(std::move(status.message));
+            return;
+        }
+
+        const std::string& cmd = args[0];
+        const std::string& sub = command.subcommand->getName();
+        if (cmd == "/map" && sub == "create") checkMapCreate(args);
+        else if (cmd == "/map" && (sub == "setblock" || sub == "fill")) checkPlacement(args);
+        else if (cmd == "/teleport") checkTeleport(args);
+        else if (cmd == "/npc" && sub == "setdialogue") requireNpc(args[2]);
+        else if (cmd == "/trigger") requireNpc(args[2]);
+        else if (cmd == "/item" && (sub == "setproperty" || sub == "give")) requireItem(args[2]);
+    }
+
+    // 物品效果块对应的物品未定义时效果永远不会执行
+    void checkItemEffect(const ScriptBlock& block) {
+        line = block.line;
+        if (!defs.items.count(block.header)) warning("使用效果对应的物品未定义: " + block.header);
+    }
+
+    Definitions defs;
+
+private:
+    std::vector<Diagnostic>& diagnostics;
+    int line = 0;
+
+    void error(std::string message) {
+        diagnostics.push_back({Diagnostic::Severity::ERROR, line, std::move(message)});
+    }
+
+    void warning(std::string message) {
+        diagnostics.push_back({Diagnostic::Severity::WARNING, line, std::move(message)});
+    }
+
+    void requireItem(const std::string& name) {
+        if (!defs.items.count(name)) error("未定义的物品: " + name);
+    }
+
+    void requireNpc(const std::string& name) {
+        if (!defs.npcs.count(name)) error("未定义的NPC: " + name);
+    }
+
+    const std::pair<int, int>* requireMap(const std::string& name) {
+        auto it = defs.maps.find(name);
+        if (it == defs.maps.end()) {
+            error("未定义的地图: " + name);
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    void checkMapCreate(const std::vector<std::string>& args) {
+        auto params = CommandUtils::parseNamedParams(args, 3);
+        int value = 0;
+        for (const char* key : {"width", "height"}) {
+            auto text = params.find(key);
+            if (text && !parseSize(*text, value)) {
+                error(std::string("地图尺寸必须是正整数: ") + key + "=" + std::string(*text));
+            }
+        }
+    }
+
+    // 检查坐标是否落在地图内
+    void checkCoordinates(int x, int y, const std::string& mapName, const std::pair<int, int>* size) {
+        if (size && (x < 0 || y < 0 || x >= size->first || y >= size->second)) {
+            error("坐标(" + std::to_string(x) + "," + std::to_string(y) + ")超出地图" + mapName +
+                  "范围(" + std::to_string(size->first) + "x" + std::to_string(size->second) + ")");
+        }
+    }
+
+    // setblock检查一个坐标，fill检查区域的两个角
+    void checkPlacement(const std::vector<std::string>& args) {
+        const auto parsed = MapCommand::parsePlacement(args);
+        if (!parsed) return;
+        const MapCommand::Placement& placement = *parsed;
+        const auto* size = requireMap(placement.map);
+        checkCoordinates(placement.x1, placement.y1, placement.map, size);
+        if (args[1] == "fill") checkCoordinates(placement.x2, placement.y2, placement.map, size);
+
+        if (placement.type == "item") requireItem(std::string(placement.params.get("name")));
+    }
+
+    void checkTeleport(const std::vector<std::string>& args) {
+        const auto* size = requireMap(args[1]);
+        if (auto pos = CommandUtils::parseCoordinates(args, 2)) checkCoordinates(pos->first, pos->second, args[1], size);
+    }
+};
+
+} // namespace
+
+std::vector<Diagnostic> ScriptValidator::validate(std::string_view source) {
+    std::vector<Diagnostic> diagnostics;
+    Script script;
+    try {
+        script = Script::compile(source);
+    } catch (const ScriptError& e) {
+        // 块结构错误时无法继续划分命令
+        diagnostics.push_back({Diagnostic::Severity::ERROR, e.getLine(), e.getDetail()});
+        return diagnostics;
+    }
+
+    Checker checker(diagnostics);
+    for (const auto& block : script.getBlocks()) {
+        for (const auto& command : block.commands) checker.collect(command);
+    }
+    for (const auto& block : script.getBlocks()) {
+        if (block.kind == ScriptBlock::Kind::ITEM_EFFECT) checker.checkItemEffect(block);
+        for (const auto& command : block.commands) checker.check(command);
+    }
+
+    std::stable_sort(diagnostics.begin(), diagnostics.end(),
+                     [](const Diagnostic& a, const Diagnostic& b) { return a.line < b.line; });
+    return diagnostics;
+}
+
+std::vector<Diagnostic> ScriptValidator::validateFile(const std::string& filename) {
+    try {
+        MappedFile file(filename);
+        return validate(file.view());
+    } catch (const std::exception& e) {
+        return {{Diagnostic::Severity::ERROR, 0, e.what()}};
+    }
+}
+
+int ScriptValidator::run(const std::vector<std::string>& files, std::ostream& out) {
+    std::vector<std::vector<Diagnostic>> results(files.size());
+
+    // 按文件领取任务，每个文件的结果写入各自的槽位
+    std::atomic<size_t> nextFile{0};
+    auto worker = [&]() {
+        for (size_t i = nextFile++; i < files.size(); i = nextFile++) {
+            results[i] = validateFile(files[i]);
+        }
+    };
+    size_t workerCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), files.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < workerCount; ++i) workers.emplace_back(worker);
+    worker();
+    for (auto& t : workers) t.join();
+
+    int errors = 0, warnings = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        for (const auto& d : results[i]) {
+            const bool isError = d.severity == Diagnostic::Severity::ERROR;
+            (isError ? errors : warnings)++;
+            out << files[i] << ":" << d.line << ": " << (isError ? "错误" : "警告") << ": " << d.message << "\n";
+        }
+    }
+    out << "已检查" << files.size() << "个文件: " << errors << "个错误, " << warnings << "个警告" << std::endl;
+    return errors;
+}
@@ -0,0 +1,58 @@
+// src/GameEngine/ScriptWatcher.cpp
+#include "ScriptWatcher.h"
+#include <stdexcept>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+ScriptWatcher::ScriptWatcher(const std::string& filename) : path(filename) {
+#ifdef __linux__
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) throw std::runtime_error("无法监视文件: " + filename);
+
+    // 监视所在目录而非文件本身，文件被替换后监视仍然有效
+    fs::path directory = path.has_parent_path() ? path.parent_path() : fs::path(".");
+    if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        close(fd);
+        throw std::runtime_error("无法监视文件: " + filename);
+    }
+#else
+    std::error_code ec;
+    lastWrite = fs::last_write_time(path, ec);
+#endif
+}
+
+ScriptWatcher::~ScriptWatcher() {
+#ifdef __linux__
+    if (fd >= 0) close(fd);
+#endif
+}
+
+bool ScriptWatcher::poll() {
+#ifdef __linux__
+    // 一次读空所有事件，只关心目标文件名
+    alignas(inotify_event) char buffer[4096];
+    const std::string target = path.filename().string();
+    bool changed = false;
+    ssize_t length;
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+        for (char* p = buffer; p < buffer + length; ) {
+            auto* event = reinterpret_cast<inotify_event*>(p);
+            if (event->len > 0 && target == event->name) changed = true;
+            p += sizeof(inotify_event) + event->len;
+        }
+    }
+    return changed;
+#else
+    std::error_code ec;
+    auto current = fs::last_write_time(path, ec);
+    if (ec || current == lastWrite) return false;
+    lastWrite = current;
+    return true;
+#endif
+}
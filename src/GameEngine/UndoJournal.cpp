@@ -0,0 +1,230 @@
+// src/GameEngine/UndoJournal.cpp
+#include "UndoJournal.h"
+#include "GameEngine.h"
+#include "EntitySelector.h"
+#include "ConcreteCommands/MapCommand.h"
+
+void UndoJournal::record(const CompiledCommand& command) {
+    const auto& args = command.args;
+    if (args.size() < 3 || !command.handler) return;
+
+    const std::string& cmd = args[0];
+    const std::string& sub = args[1];
+    if (cmd == "/map") {
+        if (sub == "create") recordMap(args[2]);
+        else if (sub == "setblock" || sub == "fill") recordPlacement(args);
+    } else if (cmd == "/item") {
+        if (sub == "define" || sub == "setproperty") recordItem(args[2]);
+        else if (sub == "give" && firstRecord("inventory")) {
+            entries.push_back(InventoryEntry{engine.inventoryManager.items, engine.inventoryManager.itemInstanceCounter,
+                                             engine.itemInstanceCounter});
+        }
+    } else if (cmd == "/npc") {
+        if (sub == "create" || sub == "setdialogue") recordNpc(args[2]);
+    } else if (cmd == "/scoreboard") {
+        if (sub == "objectives") {
+            if (args.size() >= 4) recordObjective(args[3]);
+        } else if (EntitySelector::isSelector(args[2])) {
+            if (args.size() >= 4) recordObjective(args[3]);
+        } else {
+            recordVariable(args[2]);
+        }
+    } else if (cmd == "/entity") {
+        if (sub == "set") recordEntity(args[2]);
+    } else if (cmd == "/teleport") {
+        recordPlayer();
+    } else if (cmd == "/schedule") {
+        if (sub != "list" && firstRecord("timer:" + args[2])) {
+            entries.push_back(TimerEntry{args[2], engine.scheduler.find(args[2])});
+        }
+    }
+}
+
+void UndoJournal::recordArea(const std::string& mapName, int x1, int y1, int x2, int y2) {
+    if (recorded.count("map:" + mapName)) return; // 整张地图已记录
+    GameMap& gameMap = engine.getMap(mapName);
+    entries.push_back(AreaEntry{mapName, x1, y1, x2, y2, gameMap.copyArea(x1, y1, x2, y2)});
+}
+
+void UndoJournal::recordItem(const std::string& name) {
+    if (!firstRecord("item:" + name)) return;
+    ItemEntry entry{name, std::nullopt, std::nullopt};
+    if (auto it = engine.items.find(name); it != engine.items.end()) entry.before = it->second;
+    if (auto it = engine.itemEffects.find(name); it != engine.itemEffects.end()) entry.effects = it->second;
+    entries.push_back(std::move(entry));
+}
+
+void UndoJournal::recordMap(const std::string& name) {
+    if (engine.isDeferredMap(name)) {
+        recordPending(name);
+        return;
+    }
+    if (!firstRecord("map:" + name)) return;
+    if (!engine.hasMap(name)) {
+        entries.push_back(MapEntry{name, std::nullopt});
+        return;
+    }
+    entries.push_back(MapEntry{name, engine.getMap(name)});
+}
+
+void UndoJournal::recordPending(const std::string& name) {
+    if (!firstRecord("pending:" + name)) return;
+    PendingEntry entry{name, std::nullopt, engine.maps.count(name) > 0};
+    if (auto it = engine.pendingMaps.find(name); it != engine.pendingMaps.end()) entry.before = it->second;
+    entries.push_back(std::move(entry));
+}
+
+void UndoJournal::recordPlacement(const std::vector<std::string>& args) {
+    const std::string& name = args[2];
+    if (engine.isDeferredMap(name)) {
+        recordPending(name);
+        return;
+    }
+    // 地图不存在时命令会创建空地图
+    if (!engine.hasMap(name)) {
+        recordMap(name);
+        return;
+    }
+
+    // 参数不足或坐标无效时命令同样会失败，没有需要记录的修改
+    if (const auto placement = MapCommand::parsePlacement(args)) {
+        recordArea(name, placement->x1, placement->y1, placement->x2, placement->y2);
+    }
+}
+
+void UndoJournal::recordNpc(const std::string& name) {
+    if (!firstRecord("npc:" + name)) return;
+    NpcEntry entry{name, std::nullopt};
+    if (auto it = engine.npcTemplates.find(name); it != engine.npcTemplates.end()) entry.before = it->second;
+    entries.push_back(std::move(entry));
+}
+
+void UndoJournal::recordVariable(const std::string& name) {
+    if (!firstRecord("var:" + name)) return;
+    VariableEntry entry{name, std::nullopt};
+    if (auto it = engine.variables.find(name); it != engine.variables.end()) entry.before = it->second;
+    entries.push_back(std::move(entry));
+}
+
+void UndoJournal::recordObjective(const std::string& name) {
+    if (!firstRecord("objective:" + name)) return;
+    ObjectiveEntry entry{name, std::nullopt};
+    auto& objectives = engine.scoreboard.objectives;
+    if (auto it = objectives.find(name); it != objectives.end()) entry.before = it->second;
+    entries.push_back(std::move(entry));
+}
+
+void UndoJournal::recordPlayer() {
+    if (firstRecord("player")) {
+        entries.push_back(PlayerEntry{engine.currentMap, engine.playerX, engine.playerY, engine.playerDir});
+    }
+}
+
+void UndoJournal::recordEntity(const std::string& name) {
+    // 查找顺序与/entity set一致：选择器、NPC、物品、地图对象
+    if (EntitySelector::isSelector(name)) {
+        for (const SelectedEntity& entity : EntitySelector::parse(name).select(engine)) {
+            recordArea(entity.mapName, entity.object.x, entity.object.y, entity.object.x, entity.object.y);
+        }
+    } else if (engine.npcTemplates.count(name)) {
+        recordNpc(name);
+    } else if (engine.items.count(name)) {
+        recordItem(name);
+    } else {
+        recordMapEntity(name);
+    }
+}
+
+void UndoJournal::recordMapEntity(const std::string& name) {
+    // 与GameEngine::findEntity一致：先查已构建的地图，未找到时命令才会构建放置了该实体的地图
+    for (auto& [mapName, gameMap] : engine.maps) {
+        if (engine.pendingMaps.count(mapName)) continue;
+        if (GameObject* obj = gameMap.findObjectByName(name)) {
+            recordArea(mapName, obj->x, obj->y, obj->x, obj->y);
+            return;
+        }
+    }
+    for (const auto& mapName : engine.pendingMapsWithEntity(name)) recordPending(mapName);
+}
+
+void UndoJournal::rollback() {
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        std::visit([this](auto& entry) { undo(entry); }, *it);
+    }
+    restoreEntityIds();
+    entries.clear();
+    recorded.clear();
+    failed = false;
+}
+
+void UndoJournal::restoreEntityIds() {
+    const GameMap::EntityIdState current = GameMap::entityIdState();
+    if (current.next == entityIds.next && current.released == entityIds.released) return;
+
+    // 事务中计分的实体不在其他日志项中：事务开始时未分配的ID从对象上清除
+    auto unallocated = [this](std::uint32_t id) { return id >= entityIds.next || entityIds.released.count(id) > 0; };
+    for (auto& [mapName, gameMap] : engine.maps) {
+        for (auto& [pos, obj] : gameMap.objects) {
+            if (obj.entityId != 0 && unallocated(obj.entityId)) obj.entityId = 0;
+        }
+    }
+    GameMap::restoreEntityIdState(entityIds);
+}
+
+void UndoJournal::undo(AreaEntry& entry) {
+    auto it = engine.maps.find(entry.map);
+    if (it != engine.maps.end()) it->second.restoreArea(entry.x1, entry.y1, entry.x2, entry.y2, entry.before);
+}
+
+void UndoJournal::undo(MapEntry& entry) {
+    if (entry.before) engine.maps.insert_or_assign(entry.map, std::move(*entry.before));
+    else engine.maps.erase(entry.map);
+}
+
+void UndoJournal::undo(PendingEntry& entry) {
+    // 事务中可能已构建或预构建该地图，恢复为原来的待构建状态
+    engine.prefetchedMaps.erase(entry.map);
+    if (!entry.built) engine.maps.erase(entry.map);
+    if (entry.before) engine.pendingMaps[entry.map] = std::move(*entry.before);
+    else engine.pendingMaps.erase(entry.map);
+}
+
+void UndoJournal::undo(ItemEntry& entry) {
+    if (entry.before) engine.items[entry.name] = std::move(*entry.before);
+    else engine.items.erase(entry.name);
+    if (entry.effects) engine.itemEffects[entry.name] = std::move(*entry.effects);
+    else engine.itemEffects.erase(entry.name);
+}
+
+void UndoJournal::undo(NpcEntry& entry) {
+    if (entry.before) engine.npcTemplates[entry.name] = std::move(*entry.before);
+    else engine.npcTemplates.erase(entry.name);
+}
+
+void UndoJournal::undo(VariableEntry& entry) {
+    if (entry.before) engine.variables[entry.name] = *entry.before;
+    else engine.variables.erase(entry.name);
+}
+
+void UndoJournal::undo(ObjectiveEntry& entry) {
+    auto& objectives = engine.scoreboard.objectives;
+    if (entry.before) objectives[entry.name] = std::move(*entry.before);
+    else objectives.erase(entry.name);
+}
+
+void UndoJournal::undo(InventoryEntry& entry) {
+    engine.inventoryManager.items = std::move(entry.items);
+    engine.inventoryManager.itemInstanceCounter = entry.instanceCounter;
+    engine.itemInstanceCounter = entry.engineCounter;
+}
+
+void UndoJournal::undo(PlayerEntry& entry) {
+    engine.currentMap = entry.map;
+    engine.playerX = entry.x;
+    engine.playerY = entry.y;
+    engine.playerDir = entry.dir;
+}
+
+void UndoJournal::undo(TimerEntry& entry) {
+    engine.scheduler.restore(entry.name, entry.before);
+}
@@ -0,0 +1,372 @@
+// src/GameEngine/WorldSnapshot.cpp
+#include "WorldSnapshot.h"
+#include "GameEngine.h"
+#include "MappedFile.h"
+#include "CommandParser.h"
+#include "Log.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+
+using namespace std;
+
+namespace {
+
+constexpr char MAGIC[8] = {'G', 'E', 'S', 'N', 'A', 'P', '\0', '\0'};
+
+// 属性值类型标记（与PropertyValue的备选类型对应）
+enum PropertyTag : uint8_t { TAG_INT = 0, TAG_FLOAT = 1, TAG_STRING = 2, TAG_BOOL = 3 };
+
+// 顺序写入的二进制缓冲区
+class Writer {
+public:
+    template<typename T>
+    void pod(T value) {
+        static_assert(is_trivially_copyable_v<T>);
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void str(string_view text) {
+        pod(static_cast<uint32_t>(text.size()));
+        buffer.append(text.data(), text.size());
+    }
+
+    void object(const GameObject& obj) {
+        pod<int32_t>(obj.x);
+        pod<int32_t>(obj.y);
+        str(obj.getDisplayText());
+        str(obj.name);
+        str(obj.type);
+        pod<uint32_t>(obj.entityId);
+
+        pod(static_cast<uint32_t>(obj.properties.size()));
+        for (const auto& [key, value] : obj.properties) {
+            str(key);
+            visit([this](auto&& arg) {
+                using T = decay_t<decltype(arg)>;
+                if constexpr (is_same_v<T, int>)         { pod<uint8_t>(TAG_INT); pod<int32_t>(arg); }
+                else if constexpr (is_same_v<T, float>)  { pod<uint8_t>(TAG_FLOAT); pod<float>(arg); }
+                else if constexpr (is_same_v<T, string>) { pod<uint8_t>(TAG_STRING); str(arg); }
+                else                                     { pod<uint8_t>(TAG_BOOL); pod<uint8_t>(arg ? 1 : 0); }
+            }, value);
+        }
+
+        pod(static_cast<uint32_t>(obj.dialogues.size()));
+        for (const auto& [condition, dialogue] : obj.dialogues) {
+            str(condition);
+            str(dialogue);
+        }
+
+        pod(static_cast<uint32_t>(obj.useEffects.size()));
+        for (const auto& effect : obj.useEffects) str(effect);
+    }
+
+    const string& data() const { return buffer; }
+
+private:
+    string buffer;
+};
+
+// 带边界检查的顺序读取器，直接读取映射内存
+class Reader {
+public:
+    explicit Reader(string_view data) : data(data) {}
+
+    template<typename T>
+    T pod() {
+        static_assert(is_trivially_copyable_v<T>);
+        require(sizeof(T));
+        T value;
+        memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    string_view view() {
+        uint32_t size = pod<uint32_t>();
+        require(size);
+        string_view text = data.substr(pos, size);
+        pos += size;
+        return text;
+    }
+
+    string str() { return string(view()); }
+
+    // 记录数量上限为剩余字节数，防止损坏数据导致超大分配
+    uint32_t count() {
+        uint32_t n = pod<uint32_t>();
+        if (n > data.size() - pos) throw runtime_error("快照已损坏");
+        return n;
+    }
+
+    GameObject object() {
+        GameObject obj;
+        obj.x = pod<int32_t>();
+        obj.y = pod<int32_t>();
+        obj.setDisplay(view());
+        obj.name = str();
+        obj.type = str();
+        obj.entityId = pod<uint32_t>();
+
+        for (uint32_t n = count(); n > 0; --n) {
+            string key = str();
+            switch (pod<uint8_t>()) {
+                case TAG_INT:    obj.properties.emplace(std::move(key), static_cast<int>(pod<int32_t>())); break;
+                case TAG_FLOAT:  obj.properties.emplace(std::move(key), pod<float>()); break;
+                case TAG_STRING: obj.properties.emplace(std::move(key), str()); break;
+                case TAG_BOOL:   obj.properties.emplace(std::move(key), pod<uint8_t>() != 0); break;
+                default: throw runtime_error("快照已损坏");
+            }
+        }
+
+        for (uint32_t n = count(); n > 0; --n) {
+            string condition = str();
+            obj.dialogues[condition] = str();
+        }
+
+        for (uint32_t n = count(); n > 0; --n) obj.useEffects.push_back(str());
+        return obj;
+    }
+
+    bool atEnd() const { return pos == data.size(); }
+
+private:
+    string_view data;
+    size_t pos = 0;
+
+    void require(size_t size) const {
+        if (size > data.size() - pos) throw runtime_error("快照已损坏");
+    }
+};
+
+} // namespace
+
+uint64_t WorldSnapshot::hash(string_view content, bool strict) {
+    uint64_t h = 14695981039346656037ULL;
+    auto mix = [&h](unsigned char byte) {
+        h ^= byte;
+        h *= 1099511628211ULL;
+    };
+    for (int i = 0; i < 4; ++i) mix(static_cast<unsigned char>(VERSION >> (i * 8)));
+    mix(strict ? 1 : 0);
+    for (char c : content) mix(static_cast<unsigned char>(c));
+    return h;
+}
+
+bool WorldSnapshot::load(GameEngine& engine, const string& filename, uint64_t scriptHash) {
+    // 快照不存在是常见情况，不记录错误
+    if (!ifstream(filename).good()) return false;
+
+    try {
+        MappedFile file(filename);
+        Reader in(file.view());
+
+        char magic[sizeof(MAGIC)];
+        for (char& c : magic) c = in.pod<char>();
+        if (memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+        if (in.pod<uint32_t>() != VERSION) return false;
+        if (in.pod<uint64_t>() != scriptHash) return false;
+
+        // 玩家状态
+        engine.currentMap = in.str();
+        engine.playerX = in.pod<int32_t>();
+        engine.playerY = in.pod<int32_t>();
+        engine.playerDir = in.pod<char>();
+        engine.itemInstanceCounter = in.pod<int32_t>();
+        engine.inventoryManager.itemInstanceCounter = in.pod<int32_t>();
+        GameMap::EntityIdState entityIds;
+        entityIds.next = in.pod<uint32_t>();
+        for (uint32_t n = in.count(); n > 0; --n) entityIds.released.insert(in.pod<uint32_t>());
+        GameMap::restoreEntityIdState(std::move(entityIds));
+
+        for (uint32_t n = in.count(); n > 0; --n) {
+            string name = in.str();
+            engine.variables[name] = in.pod<int32_t>();
+        }
+        for (uint32_t n = in.count(); n > 0; --n) engine.visitedMarkers.insert(in.str());
+
+        for (uint32_t n = in.count(); n > 0; --n) {
+            string name = in.str();
+            Scoreboard::Objective& objective = engine.scoreboard.objectives[name];
+            objective.defaultValue = in.pod<int32_t>();
+            objective.values.resize(in.count() / sizeof(int32_t));
+            for (int& value : objective.values) value = in.pod<int32_t>();
+        }
+
+        for (uint32_t n = in.count(); n > 0; --n) {
+            string name = in.str();
+            engine.npcTemplates[name] = in.object();
+        }
+        for (uint32_t n = in.count(); n > 0; --n) {
+            string name = in.str();
+            GameObject& item = engine.items[name] = in.object();
+            // 使用效果只保存源码，恢复时重新编译
+            for (const auto& effect : item.useEffects) {
+                engine.itemEffects[name].push_back(CommandParser::compile(effect));
+            }
+        }
+        for (uint32_t n = in.count(); n > 0; --n) engine.inventoryManager.getItems().push_back(in.object());
+
+        // 地图对象按原实体ID直接插入，不重新分配
+        for (uint32_t n = in.count(); n > 0; --n) {
+            string name = in.str();
+            int width = in.pod<int32_t>();
+            int height = in.pod<int32_t>();
+            GameMap& gameMap = engine.maps.emplace(name, GameMap(width, height)).first->second;
+            for (uint32_t m = in.count(); m > 0; --m) {
+                GameObject obj = in.object();
+                auto it = gameMap.objects.insert_or_assign({obj.x, obj.y}, std::move(obj)).first;
+                gameMap.indexObject(it->first, it->second);
+            }
+        }
+
+        // 尚未构建的地图保存的是构建命令
+        for (uint32_t n = in.count(); n > 0; --n) {
+            string name = in.str();
+            PendingMapProgram& program = engine.pendingMaps[name];
+            for (uint32_t m = in.count(); m > 0; --m) {
+                vector<string> args(in.count());
+                for (auto& arg : args) arg = in.str();
+                PendingMapCommand& pending = program.emplace_back();
+                pending.command = CommandParser::compile(std::move(args));
+                for (uint32_t k = in.count(); k > 0; --k) {
+                    string itemName = in.str();
+                    pending.items.emplace(std::move(itemName), in.object());
+                }
+            }
+        }
+
+        // 定时器按添加顺序恢复，保存的是剩余回合数
+        for (uint32_t n = in.count(); n > 0; --n) {
+            string name = in.str();
+            uint32_t remaining = in.pod<uint32_t>();
+            uint32_t interval = in.pod<uint32_t>();
+            vector<string> args(in.count());
+            for (auto& arg : args) arg = in.str();
+            engine.scheduler.schedule(name, remaining, interval, CommandParser::compile(std::move(args)));
+        }
+
+        if (!in.atEnd()) throw runtime_error("快照已损坏");
+        return true;
+    } catch (const exception& e) {
+        Log log("error.log");
+        log.error("快照读取失败，改为执行脚本: ", string(e.what()));
+
+        // 恢复为空状态，由调用方重新执行脚本
+        engine.maps.clear();
+        engine.pendingMaps.clear();
+        engine.npcTemplates.clear();
+        engine.items.clear();
+        engine.itemEffects.clear();
+        engine.variables.clear();
+        engine.visitedMarkers.clear();
+        engine.scoreboard.clear();
+        engine.inventoryManager.clear();
+        engine.scheduler = Scheduler();
+        GameMap::restoreEntityIdState({});
+        return false;
+    }
+}
+
+void WorldSnapshot::save(const GameEngine& engine, const string& filename, uint64_t scriptHash) {
+    Writer out;
+    for (char c : MAGIC) out.pod(c);
+    out.pod(VERSION);
+    out.pod(scriptHash);
+
+    out.str(engine.currentMap);
+    out.pod<int32_t>(engine.playerX);
+    out.pod<int32_t>(engine.playerY);
+    out.pod<char>(engine.playerDir);
+    out.pod<int32_t>(engine.itemInstanceCounter);
+    out.pod<int32_t>(engine.inventoryManager.itemInstanceCounter);
+    const GameMap::EntityIdState entityIds = GameMap::entityIdState();
+    out.pod<uint32_t>(entityIds.next);
+    out.pod(static_cast<uint32_t>(entityIds.released.size()));
+    for (uint32_t id : entityIds.released) out.pod<uint32_t>(id);
+
+    out.pod(static_cast<uint32_t>(engine.variables.size()));
+    for (const auto& [name, value] : engine.variables) {
+        out.str(name);
+        out.pod<int32_t>(value);
+    }
+    out.pod(static_cast<uint32_t>(engine.visitedMarkers.size()));
+    for (const auto& marker : engine.visitedMarkers) out.str(marker);
+
+    const auto& objectives = engine.scoreboard.getObjectives();
+    out.pod(static_cast<uint32_t>(objectives.size()));
+    for (const auto& [name, objective] : objectives) {
+        out.str(name);
+        out.pod<int32_t>(objective.defaultValue);
+        out.pod(static_cast<uint32_t>(objective.values.size() * sizeof(int32_t)));
+        for (int value : objective.values) out.pod<int32_t>(value);
+    }
+
+    out.pod(static_cast<uint32_t>(engine.npcTemplates.size()));
+    for (const auto& [name, npc] : engine.npcTemplates) {
+        out.str(name);
+        out.object(npc);
+    }
+    out.pod(static_cast<uint32_t>(engine.items.size()));
+    for (const auto& [name, item] : engine.items) {
+        out.str(name);
+        out.object(item);
+    }
+    const auto& inventory = engine.inventoryManager.getItems();
+    out.pod(static_cast<uint32_t>(inventory.size()));
+    for (const auto& item : inventory) out.object(item);
+
+    out.pod(static_cast<uint32_t>(engine.maps.size()));
+    for (const auto& [name, gameMap] : engine.maps) {
+        out.str(name);
+        out.pod<int32_t>(gameMap.getWidth());
+        out.pod<int32_t>(gameMap.getHeight());
+        out.pod(static_cast<uint32_t>(gameMap.getAllObjects().size()));
+        for (const auto& [pos, obj] : gameMap.getAllObjects()) out.object(obj);
+    }
+
+    out.pod(static_cast<uint32_t>(engine.pendingMaps.size()));
+    for (const auto& [name, program] : engine.pendingMaps) {
+        out.str(name);
+        out.pod(static_cast<uint32_t>(program.size()));
+        for (const auto& [command, items] : program) {
+            out.pod(static_cast<uint32_t>(command.args.size()));
+            for (const auto& arg : command.args) out.str(arg);
+            out.pod(static_cast<uint32_t>(items.size()));
+            for (const auto& [itemName, item] : items) {
+                out.str(itemName);
+                out.object(item);
+            }
+        }
+    }
+
+    const auto timers = engine.scheduler.list();
+    out.pod(static_cast<uint32_t>(timers.size()));
+    for (const auto& timer : timers) {
+        out.str(timer.name);
+        out.pod(static_cast<uint32_t>(timer.remaining));
+        out.pod(timer.interval);
+        out.pod(static_cast<uint32_t>(timer.command->args.size()));
+        for (const auto& arg : timer.command->args) out.str(arg);
+    }
+
+    // 先写临时文件再替换，避免中断时留下半个快照
+    string tempFile = filename + ".tmp";
+    {
+        ofstream file(tempFile, ios::binary | ios::trunc);
+        file.write(out.data().data(), static_cast<streamsize>(out.data().size()));
+        if (!file) {
+            Log log("error.log");
+            log.error("快照写入失败: ", filename);
+            return;
+        }
+    }
+    if (rename(tempFile.c_str(), filename.c_str()) != 0) {
+        remove(tempFile.c_str());
+        Log log("error.log");
+        log.error("快照写入失败: ", filename);
+    }
+}
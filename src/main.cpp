@@ -1,15 +1,82 @@
 // File: src/main.cpp
 #include "GameEngine.h"
+#include "PluginHost.h"
+#include "ScriptValidator.h"
+#include <clocale>
 #include <iostream>
 #include <exception>
+#include <string>
+#include <vector>
+#include <ncurses.h>
+
+namespace {
+int usage(const char* program) {
+    std::cerr << "用法: " << program << " [--watch] [--strict] [--profile] [--plugin <库>]...\n"
+              << "      " << program << " --validate [--with-plugins] [--plugin <库>]... [文件...]" << std::endl;
+    return EXIT_FAILURE;
+}
+}
+
+int main(int argc, char* argv[]) {
+    // 宽字符输出依赖本地化设置，在其他初始化之前设置
+    setlocale(LC_ALL, "");
+
+    // 命令行参数：--watch 开启脚本热重载；--strict 执行失败的块整体撤销；
+    // --profile 统计加载开销；--validate [文件...] 只检查脚本，不启动游戏；
+    // --plugin <库> 加载原生插件（可重复）；游戏脚本所在目录的plugins/下的插件总是加载，
+    // 校验时只在指定--with-plugins时加载（按第一个被校验的文件所在目录）
+    const std::string scriptFile = "game.txt";
+    bool watch = false;
+    bool strict = false;
+    bool profile = false;
+    bool validate = false;
+    bool withPlugins = false;
+    std::vector<std::string> scriptFiles;
+    std::vector<std::string> pluginFiles;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--watch") watch = true;
+        else if (arg == "--strict") strict = true;
+        else if (arg == "--profile") profile = true;
+        else if (arg == "--validate") validate = true;
+        else if (arg == "--with-plugins") withPlugins = true;
+        else if (arg == "--plugin" && i + 1 < argc) pluginFiles.push_back(argv[++i]);
+        else if (arg.rfind("-", 0) == 0) {
+            std::cerr << (arg == "--plugin" ? "缺少插件路径: " : "未知选项: ") << arg << std::endl;
+            return usage(argv[0]);
+        } else {
+            scriptFiles.push_back(arg);
+        }
+    }
+    // 脚本文件参数只用于校验模式，游戏总是加载当前目录下的game.txt
+    if (!validate && !scriptFiles.empty()) {
+        std::cerr << "只有--validate模式接受文件参数: " << scriptFiles[0] << std::endl;
+        return usage(argv[0]);
+    }
+
+    if (validate && scriptFiles.empty()) scriptFiles.push_back(scriptFile);
+
+    // 插件注册的命令需在编译脚本之前就绪（校验时也需要）
+    PluginHost& plugins = PluginHost::getInstance();
+    if (!validate || withPlugins) plugins.loadDirectory(PluginHost::directoryFor(validate ? scriptFiles[0] : scriptFile));
+    for (const auto& file : pluginFiles) {
+        if (!plugins.load(file)) std::cerr << "无法加载插件: " << file << "（详见error.log）" << std::endl;
+    }
+
+    // 校验模式在创建引擎之前处理，不初始化终端
+    if (validate) {
+        return ScriptValidator::run(scriptFiles, std::cout) > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
 
-int main() {
     try {
         // 初始化游戏引擎
         GameEngine engine;
         
         // 加载游戏数据
-        engine.loadGame("game.txt");
+        engine.setStrictLoading(strict);
+        engine.setProfiling(profile);
+        engine.loadGame(scriptFile);
+        if (watch) engine.enableHotReload();
         
         // 启动主游戏循环
         engine.startGameLoop();